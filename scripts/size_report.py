@@ -0,0 +1,61 @@
+# 빌드 후 구성(env)별 flash / static RAM 크기 출력
+# --------------------------------------------
+# 1. platformio.ini 의 extra_scripts 로 등록되어 firmware.elf 가 만들어질 때마다 실행됩니다
+# 2. 섹션 크기를 flash(코드+상수+초기값), ram(전역/정적 변수), rtc(RTC_DATA_ATTR)로 묶어 출력합니다
+# 3. .pio/build/size_report.txt 에 구성별로 한 줄씩 갱신해 구성끼리 비교할 수 있습니다
+
+import os
+import subprocess
+
+Import("env")
+
+FLASH_SECTIONS = (".flash.text", ".flash.rodata", ".flash.appdesc", ".iram0.vectors", ".iram0.text", ".dram0.data")
+RAM_SECTIONS   = (".dram0.data", ".dram0.bss", ".noinit")
+RTC_SECTIONS   = (".rtc.text", ".rtc.data", ".rtc.bss", ".rtc.force_fast", ".rtc.force_slow", ".rtc_noinit")
+
+
+def read_sections(elf):
+    out = subprocess.run([env.subst("$SIZETOOL"), "-A", elf], capture_output=True, text=True).stdout
+    sections = {}
+
+    for line in out.splitlines():
+        parts = line.split()
+
+        if len(parts) < 2 or not parts[0].startswith("."):
+            continue
+
+        try:
+            sections[parts[0]] = int(parts[1])
+        except ValueError:
+            pass
+
+    return sections
+
+
+def size_report(source, target, env):
+    sections = read_sections(str(target[0]))
+    name  = env.subst("$PIOENV")
+    flash = sum(sections.get(s, 0) for s in FLASH_SECTIONS)
+    ram   = sum(sections.get(s, 0) for s in RAM_SECTIONS)
+    rtc   = sum(sections.get(s, 0) for s in RTC_SECTIONS)
+    row   = "%-24s flash %8d byte   ram %7d byte   rtc %5d byte" % (name, flash, ram, rtc)
+
+    print("[size] " + row)
+
+    # 구성별로 한 줄씩 모아둠 ( 같은 구성은 최신 값으로 교체 )
+    report = os.path.join(env.subst("$PROJECT_BUILD_DIR"), "size_report.txt")
+    rows = {}
+
+    if os.path.exists(report):
+        with open(report) as f:
+            for line in f:
+                if line.strip():
+                    rows[line.split()[0]] = line.rstrip("\n")
+
+    rows[name] = row
+
+    with open(report, "w") as f:
+        f.write("\n".join(rows[k] for k in sorted(rows)) + "\n")
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", size_report)
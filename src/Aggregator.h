@@ -0,0 +1,324 @@
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+/* 개요: 측정값을 기기에서 윈도우 단위로 요약하는 헤더 입니다.
+ * --------------------------------------------
+ * 1. 측정값마다 텀블링(겹치지 않음) 또는 슬라이딩(조각 단위로 이동) 윈도우를 지정합니다
+ * 2. 윈도우가 끝날 때 min/max/mean/count 와 p50/p90/p99 요약 1개만 publish 합니다
+ * 3. 백분위수는 로그 스케일 히스토그램(스케치)으로 근사합니다 ( 상대오차 약 13%, 샘플 수와 무관하게 메모리 일정 )
+ * 4. 원본값은 최근 AGG_RAW_KEEP 개만 보관하며 "raw <이름>" 명령으로 요청 시에만 전송합니다
+ * 5. 기본으로 등록되는 측정값은 없습니다 ( env.txt의 "agg" 설정에 적은 것만 reg_metric, 스케치 메모리도 그때 할당 )
+ * 6. 조각 길이( window_ms/slices )가 0인 등록과 NaN/Inf 측정값은 거부합니다
+ *
+ * 요약 형식
+ * --------------------------------------------
+ * - TEXT   : {"m":"rssi","w":60000,"n":60,"min":..,"max":..,"mean":..,"p50":..,"p90":..,"p99":..}
+ * - MSGPACK: [5, m, w, n, min, max, mean, p50, p90, p99] ( Payload_decoder.h 의 SCHEMA_AGG )
+*/
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Payload_codec.h>
+#include <functional>
+#include <vector>
+#include <math.h>
+
+#define AGG_MAX_METRIC   6
+#define AGG_MAX_SLICE    6      // 슬라이딩 윈도우 최대 조각 수
+#define AGG_RAW_KEEP     32
+#define AGG_BUCKETS      64     // 부호별 로그 버킷 수 ( 1 ~ GAMMA^64 ≒ 19000000, PSRAM 보드의 힙 크기까지 )
+#define AGG_GAMMA        1.3f
+
+// 요약 송신 함수 ( 인자: MSGPACK용 doc, TEXT용 문자열 )
+typedef std::function<void(JsonDocument&, String)> Agg_sender;
+
+// 고정 크기 스케치 ( min/max/sum/count + 로그 히스토그램 )
+class Agg_sketch {
+    private:
+        uint16_t pos[AGG_BUCKETS];   // [GAMMA^k, GAMMA^(k+1))
+        uint16_t neg[AGG_BUCKETS];   // (-GAMMA^(k+1), -GAMMA^k]
+        uint16_t zero;               // (-1, 1)
+
+        static int bucket(float abs_v);
+        static float value(int k);
+        static void inc(uint16_t& cnt, uint32_t n) { cnt = (cnt + n < UINT16_MAX) ? cnt + n : UINT16_MAX; }
+
+    public:
+        float    min;
+        float    max;
+        double   sum;
+        uint32_t count;
+
+        void clear();
+        void add(float v);
+        void merge(const Agg_sketch& other);
+
+        // q(0~1) 백분위수 근사값
+        float quantile(float q);
+};
+
+int Agg_sketch::bucket(float abs_v) {
+    int k = (int)(logf(abs_v) / logf(AGG_GAMMA));
+
+    return k < AGG_BUCKETS ? k : AGG_BUCKETS - 1;
+}
+
+// 버킷의 대표값 ( 버킷 양 끝 대비 상대오차가 같아지는 지점 )
+float Agg_sketch::value(int k) {
+    return 2.0f * powf(AGG_GAMMA, k + 1) / (AGG_GAMMA + 1.0f);
+}
+
+void Agg_sketch::clear() {
+    memset(pos, 0, sizeof(pos));
+    memset(neg, 0, sizeof(neg));
+    zero  = 0;
+    min   = INFINITY;
+    max   = -INFINITY;
+    sum   = 0;
+    count = 0;
+}
+
+void Agg_sketch::add(float v) {
+    // NaN/Inf 는 버킷 번호로 바꿀 수 없음
+    if (!isfinite(v)) return;
+
+    if (v < min) min = v;
+    if (max < v) max = v;
+    sum += v;
+    count++;
+
+    if (-1.0f < v && v < 1.0f) inc(zero, 1);
+    else if (0 < v)            inc(pos[bucket(v)], 1);
+    else                       inc(neg[bucket(-v)], 1);
+}
+
+void Agg_sketch::merge(const Agg_sketch& other) {
+    if (other.count == 0) return;
+
+    if (other.min < min) min = other.min;
+    if (max < other.max) max = other.max;
+    sum   += other.sum;
+    count += other.count;
+
+    inc(zero, other.zero);
+    for (int k = 0; k < AGG_BUCKETS; k++) {
+        inc(pos[k], other.pos[k]);
+        inc(neg[k], other.neg[k]);
+    }
+}
+
+// q(0~1) 백분위수 근사값
+float Agg_sketch::quantile(float q) {
+    uint32_t total = zero;
+    for (int k = 0; k < AGG_BUCKETS; k++) total += pos[k] + neg[k];
+
+    if (total == 0) return 0;
+
+    uint32_t rank = (uint32_t)(q * (total - 1));
+    uint32_t seen = 0;
+    float v = max;
+
+    // 가장 작은 값(음수 큰 버킷) → 0 → 양수 큰 버킷 순서로 누적
+    for (int i = -AGG_BUCKETS; i <= AGG_BUCKETS; i++) {
+        seen += (i < 0) ? neg[-i - 1] : (i == 0 ? zero : pos[i - 1]);
+
+        if (rank < seen) {
+            v = (i < 0) ? -value(-i - 1) : (i == 0 ? 0 : value(i - 1));
+            break;
+        }
+    }
+
+    // 실제 최소/최대를 벗어나지 않도록
+    return v < min ? min : (max < v ? max : v);
+}
+
+typedef struct Agg_metric {
+    String     name;
+    uint32_t   window_ms;
+    uint32_t   slice_ms;           // 요약 주기 ( 텀블링이면 window_ms )
+    uint8_t    slices;             // 텀블링이면 1
+    uint8_t    cur;
+    uint32_t   slice_start;
+    std::vector<Agg_sketch> sk;    // 조각별 스케치 ( slices 개 )
+
+    float      raw[AGG_RAW_KEEP];  // 최근 원본값 ( 원형 버퍼 )
+    uint8_t    raw_head;
+    uint8_t    raw_cnt;
+} Agg_metric;
+
+class Aggregator {
+    private:
+        Agg_metric metrics[AGG_MAX_METRIC];
+        uint8_t    metric_cnt;
+        Agg_sender sender;
+
+        void publish(Agg_metric& m);
+
+    public:
+        Aggregator() : metric_cnt(0) {}
+        Aggregator& operator=(const Aggregator& ref) = delete;
+        static Aggregator& GetInstance();
+
+        // 초기화 ( 요약을 내보낼 함수 등록, 등록된 측정값은 모두 해제 )
+        void init(Agg_sender sender);
+
+        // 측정값 등록 ( slices가 1이면 텀블링, 2 이상이면 window_ms/slices 마다 이동하는 슬라이딩 )
+        // 반환: add()에 쓸 번호 ( 실패 시 -1 )
+        int reg_metric(String name, uint32_t window_ms, uint8_t slices = 1);
+
+        // 측정값 추가
+        void add(int id, float v);
+
+        // 최근 원본값 ( 없는 이름이면 빈 문자열 )
+        String raw(String name);
+
+        // non-blocking 실행 ( 끝난 윈도우 요약 전송 )
+        void run(uint32_t now);
+};
+
+Aggregator& Aggregator::GetInstance() {
+    static Aggregator instance;
+
+    return instance;
+}
+
+// 초기화 ( 요약을 내보낼 함수 등록, 등록된 측정값은 모두 해제 )
+void Aggregator::init(Agg_sender sender) {
+    this->sender = sender;
+
+    for (uint8_t i = 0; i < metric_cnt; i++) std::vector<Agg_sketch>().swap(metrics[i].sk);
+    metric_cnt = 0;
+}
+
+// 측정값 등록 ( slices가 1이면 텀블링, 2 이상이면 window_ms/slices 마다 이동하는 슬라이딩 )
+int Aggregator::reg_metric(String name, uint32_t window_ms, uint8_t slices) {
+    if (AGG_MAX_METRIC <= metric_cnt || slices == 0 || AGG_MAX_SLICE < slices) return -1;
+
+    // 조각 길이가 0이면 run() 마다 요약을 보내게 됨
+    if (window_ms / slices == 0) return -1;
+
+    Agg_metric& m = metrics[metric_cnt];
+
+    m.name        = name;
+    m.window_ms   = window_ms;
+    m.slices      = slices;
+    m.slice_ms    = window_ms / slices;
+    m.cur         = 0;
+    m.slice_start = millis();
+    m.raw_head    = 0;
+    m.raw_cnt     = 0;
+
+    m.sk.assign(slices, Agg_sketch());
+    for (Agg_sketch& sk : m.sk) sk.clear();
+
+    return metric_cnt++;
+}
+
+// 측정값 추가 ( NaN/Inf 는 버림 )
+void Aggregator::add(int id, float v) {
+    if (id < 0 || metric_cnt <= id || !isfinite(v)) return;
+
+    Agg_metric& m = metrics[id];
+
+    m.sk[m.cur].add(v);
+
+    m.raw[m.raw_head] = v;
+    m.raw_head = (m.raw_head + 1) % AGG_RAW_KEEP;
+    if (m.raw_cnt < AGG_RAW_KEEP) m.raw_cnt++;
+}
+
+// 최근 원본값 ( 없는 이름이면 빈 문자열 )
+String Aggregator::raw(String name) {
+    for (uint8_t i = 0; i < metric_cnt; i++) {
+        Agg_metric& m = metrics[i];
+
+        if (m.name != name) continue;
+
+        String msg = m.name + ":";
+
+        // 오래된 것부터
+        for (uint8_t k = 0; k < m.raw_cnt; k++) {
+            msg += " ";
+            msg += String(m.raw[(m.raw_head + AGG_RAW_KEEP - m.raw_cnt + k) % AGG_RAW_KEEP], 2);
+        }
+
+        return msg;
+    }
+
+    return "";
+}
+
+void Aggregator::publish(Agg_metric& m) {
+    Agg_sketch total;
+
+    total.clear();
+    for (uint8_t i = 0; i < m.slices; i++) total.merge(m.sk[i]);
+
+    if (total.count == 0) return;
+
+    float mean = total.sum / total.count;
+    float p50  = total.quantile(0.50f);
+    float p90  = total.quantile(0.90f);
+    float p99  = total.quantile(0.99f);
+
+    JsonDocument doc;
+    JsonArray arr = doc.to<JsonArray>();
+    arr.add(SCHEMA_AGG);
+    arr.add(m.name);
+    arr.add(m.window_ms);
+    arr.add(total.count);
+    arr.add(total.min);
+    arr.add(total.max);
+    arr.add(mean);
+    arr.add(p50);
+    arr.add(p90);
+    arr.add(p99);
+
+    JsonDocument text_doc;
+    String text;
+    text_doc["m"]    = m.name;
+    text_doc["w"]    = m.window_ms;
+    text_doc["n"]    = total.count;
+    text_doc["min"]  = total.min;
+    text_doc["max"]  = total.max;
+    text_doc["mean"] = mean;
+    text_doc["p50"]  = p50;
+    text_doc["p90"]  = p90;
+    text_doc["p99"]  = p99;
+    serializeJson(text_doc, text);
+
+    sender(doc, text);
+}
+
+// non-blocking 실행 ( 끝난 윈도우 요약 전송 )
+void Aggregator::run(uint32_t now) {
+    for (uint8_t i = 0; i < metric_cnt; i++) {
+        Agg_metric& m = metrics[i];
+
+        if (now - m.slice_start < m.slice_ms) continue;
+
+        publish(m);
+
+        // 다음 조각으로 이동 ( 가장 오래된 조각을 비우고 재사용 )
+        m.cur = (m.cur + 1) % m.slices;
+        m.sk[m.cur].clear();
+
+        // 오래 멈춰있었으면 밀린 조각은 건너뜀
+        m.slice_start = (now - m.slice_start < 2 * m.slice_ms) ? m.slice_start + m.slice_ms : now;
+    }
+}
+
+// Device_config.h 의 집계 정책
+struct Agg_on {
+    static void init(Agg_sender sender) { Aggregator::GetInstance().init(sender); }
+
+    static int reg_metric(String name, uint32_t window_ms, uint8_t slices = 1) {
+        return Aggregator::GetInstance().reg_metric(name, window_ms, slices);
+    }
+
+    static void add(int id, float v) { Aggregator::GetInstance().add(id, v); }
+    static String raw(String name) { return Aggregator::GetInstance().raw(name); }
+    static void run(uint32_t now) { Aggregator::GetInstance().run(now); }
+};
+
+#endif
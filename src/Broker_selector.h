@@ -0,0 +1,256 @@
+#ifndef BROKER_SELECTOR_H
+#define BROKER_SELECTOR_H
+
+/* 개요: 여러 MQTT 브로커 중 접속할 브로커를 고르는 헤더 입니다.
+ * --------------------------------------------
+ * 1. env.txt의 "mqtt": {"brokers": [...]} 에 적은 순서를 우선순위로 사용합니다 ( 없으면 broker_address 하나 )
+ * 2. WiFi 접속 시 모든 브로커에 TCP 접속 시간(RTT)을 측정해 가장 빠른 브로커를 고릅니다
+ * 3. 연속 BROKER_FAIL_MAX 번 접속에 실패하면 BROKER_HOLD_DOWN 동안 제외하고 다음 브로커로 넘어갑니다
+ * 4. 접속 중에도 BROKER_EVAL_INTERVAL 동안 한 개씩 돌아가며 다시 측정해,
+ *    BROKER_SWITCH_MARGIN(%) 이상 빠른 브로커가 있으면 옮겨갑니다
+ *    - 측정은 blocking TCP 접속이라 1개마다 loop() 가 최대 BROKER_PROBE_TIMEOUT 멈춥니다 ( probe_all 은 브로커 수 배 )
+ *    - 접속 중인 브로커의 측정 실패는 연속 실패/제외에 세지 않습니다 ( MQTT 세션이 살아있으므로 )
+ * 5. RTT는 측정할 때마다 지수이동평균으로 갱신합니다 ( 일시적인 지연에 흔들리지 않게 )
+ * 6. Network_Handler 가 하나씩 가지고 있습니다 ( 상태 확인은 net.getBrokerStats() )
+*/
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include <env.h>
+#include <Log_config.h>
+
+#define BROKER_PROBE_TIMEOUT  1000     // TCP 접속 측정 제한 시간 ( ms )
+#define BROKER_FAIL_MAX       3        // 연속 실패 시 다른 브로커로
+#define BROKER_HOLD_DOWN      300000   // 실패한 브로커 제외 시간 ( ms )
+#define BROKER_EVAL_INTERVAL  600000   // 전체 브로커 재측정 주기 ( ms )
+#define BROKER_SWITCH_MARGIN  30       // 현재보다 이만큼(%) 빨라야 옮겨감
+
+// 브로커 1개의 상태
+typedef struct Broker_state {
+    MQTT_endpoint ep;
+    uint32_t rtt_ms;      // 지수이동평균 ( 0이면 측정값 없음 )
+    uint8_t  fail_cnt;    // 연속 실패 횟수 ( 측정 + 접속 )
+    uint32_t down_until;  // 이 시각까지 제외 ( 0이면 사용 가능 )
+} Broker_state;
+
+class Broker_selector {
+    private:
+        Broker_state list[ENV_MAX_BROKER];
+        uint8_t  cnt;
+        uint8_t  cur;
+        uint8_t  probe_next;    // 다음에 재측정할 브로커
+        uint32_t probe_ms;      // 마지막 재측정 시각
+        uint32_t switch_cnt;
+
+        bool isHealthy(uint8_t i, uint32_t now);
+
+        // 가장 빠른 사용 가능한 브로커 ( 측정값이 없으면 순서가 빠른 것 )
+        uint8_t best(uint32_t now);
+
+        // 1개 측정 ( 실패 시 false, count_fail이 false면 실패해도 측정값/제외 상태 유지 )
+        bool probe(uint8_t i, bool count_fail = true);
+
+        void choose(uint8_t i, const char* reason);
+
+    public:
+        Broker_selector() = default;
+        Broker_selector& operator=(const Broker_selector& ref) = delete;
+
+        // 초기화 ( 후보 브로커 목록 )
+        void init(const MQTT_endpoint* eps, uint8_t cnt);
+
+        // 현재 선택된 브로커
+        const MQTT_endpoint& current() { return list[cur].ep; }
+
+        // 모든 브로커를 측정해 가장 빠른 브로커 선택 ( WiFi 접속 직후 호출, 후보가 1개면 생략 )
+        void probe_all();
+
+        // MQTT 접속 결과 반영 ( 다른 브로커로 바뀌었으면 true )
+        bool report(bool ok);
+
+        // non-blocking 실행 ( 접속 중 주기적 재측정, 더 빠른 브로커로 바꿔야 하면 true )
+        bool run();
+
+        // 브로커별 상태 ( JSON 문자열 )
+        String stats();
+};
+
+// 초기화 ( 후보 브로커 목록 )
+void Broker_selector::init(const MQTT_endpoint* eps, uint8_t cnt) {
+    this->cnt  = cnt < ENV_MAX_BROKER ? cnt : ENV_MAX_BROKER;
+    cur        = 0;
+    probe_next = 0;
+    probe_ms   = millis();
+    switch_cnt = 0;
+
+    FOR(i, 0, this->cnt) list[i] = { eps[i], 0, 0, 0 };
+}
+
+bool Broker_selector::isHealthy(uint8_t i, uint32_t now) {
+    if (list[i].down_until == 0) return true;
+
+    // 제외 시간이 지났으면 다시 후보로
+    if ((int32_t)(now - list[i].down_until) >= 0) {
+        list[i].down_until = 0;
+        list[i].fail_cnt   = 0;
+        return true;
+    }
+
+    return false;
+}
+
+// 가장 빠른 사용 가능한 브로커 ( 측정값이 없으면 순서가 빠른 것 )
+uint8_t Broker_selector::best(uint32_t now) {
+    int pick = -1;
+
+    FOR(i, 0, cnt) {
+        if (!isHealthy(i, now)) continue;
+
+        if (pick < 0) { pick = i; continue; }
+
+        // 측정된 것이 측정 안된 것보다 우선, 둘 다 측정됐으면 빠른 것
+        uint32_t a = list[i].rtt_ms, b = list[pick].rtt_ms;
+
+        if (a && (!b || a < b)) pick = i;
+    }
+
+    // 모두 제외됐으면 가장 먼저 풀리는 브로커
+    if (pick < 0) {
+        pick = 0;
+        FOR(i, 1, cnt) if ((int32_t)(list[i].down_until - list[pick].down_until) < 0) pick = i;
+    }
+
+    return pick;
+}
+
+// 1개 측정 ( 실패 시 false, count_fail이 false면 실패해도 측정값/제외 상태 유지 )
+bool Broker_selector::probe(uint8_t i, bool count_fail) {
+    WiFiClient client;
+    uint32_t begin = millis();
+    bool ok = client.connect(list[i].ep.address, list[i].ep.port, BROKER_PROBE_TIMEOUT);
+    uint32_t rtt = millis() - begin;
+
+    client.stop();
+
+    if (!ok) {
+        Dev_log::printf("[Broker] %s:%d 측정 실패\n", list[i].ep.address, list[i].ep.port);
+
+        if (!count_fail) return false;
+
+        // 측정값을 버려 응답하는 브로커보다 뒤로, 계속 실패하면 제외
+        list[i].rtt_ms = 0;
+        if (BROKER_FAIL_MAX <= ++list[i].fail_cnt) list[i].down_until = (millis() + BROKER_HOLD_DOWN) | 1;
+
+        return false;
+    }
+
+    if (rtt == 0) rtt = 1;
+
+    // 지수이동평균 ( 새 값 1/4 반영 )
+    list[i].rtt_ms   = list[i].rtt_ms ? (list[i].rtt_ms * 3 + rtt) / 4 : rtt;
+    list[i].fail_cnt = 0;
+
+    return true;
+}
+
+void Broker_selector::choose(uint8_t i, const char* reason) {
+    if (i == cur) return;
+
+    Dev_log::printf("[Broker] %s:%d → %s:%d (%s)\n",
+        list[cur].ep.address, list[cur].ep.port,
+        list[i].ep.address, list[i].ep.port,
+        reason
+    );
+
+    cur = i;
+    switch_cnt++;
+}
+
+// 모든 브로커를 측정해 가장 빠른 브로커 선택 ( WiFi 접속 직후 호출, 후보가 1개면 생략 )
+void Broker_selector::probe_all() {
+    if (cnt < 2) return;
+
+    uint32_t now = millis();
+
+    FOR(i, 0, cnt) {
+        if (isHealthy(i, now)) probe(i);
+    }
+
+    probe_ms = millis();
+
+    choose(best(probe_ms), "fastest");
+}
+
+// MQTT 접속 결과 반영 ( 다른 브로커로 바뀌었으면 true )
+bool Broker_selector::report(bool ok) {
+    Broker_state& b = list[cur];
+
+    if (ok) {
+        b.fail_cnt = 0;
+        return false;
+    }
+
+    if (++b.fail_cnt < BROKER_FAIL_MAX || cnt < 2) return false;
+
+    // 연속 실패한 브로커는 잠시 제외하고 다음 후보로
+    b.down_until = (millis() + BROKER_HOLD_DOWN) | 1;
+
+    uint8_t prev = cur;
+    choose(best(millis()), "failover");
+
+    return cur != prev;
+}
+
+// non-blocking 실행 ( 접속 중 주기적 재측정, 더 빠른 브로커로 바꿔야 하면 true )
+bool Broker_selector::run() {
+    if (cnt < 2 || millis() - probe_ms < BROKER_EVAL_INTERVAL / cnt) return false;
+
+    probe_ms = millis();
+
+    uint8_t i = probe_next;
+    probe_next = (probe_next + 1) % cnt;
+
+    if (!isHealthy(i, probe_ms)) return false;
+
+    // 현재 브로커도 같이 측정되도록 순서대로 1개씩 ( 접속 중인 브로커의 실패는 세지 않음 )
+    if (!probe(i, i != cur) || i == cur) return false;
+
+    // 현재보다 충분히 빠를 때만 ( 비슷한 브로커끼리 왔다갔다 하지 않도록 )
+    uint32_t cur_rtt = list[cur].rtt_ms;
+
+    if (cur_rtt && list[i].rtt_ms * 100 < cur_rtt * (100 - BROKER_SWITCH_MARGIN)) {
+        choose(i, "faster");
+        return true;
+    }
+
+    return false;
+}
+
+// 브로커별 상태 ( JSON 문자열 )
+String Broker_selector::stats() {
+    JsonDocument doc;
+    String msg;
+    uint32_t now = millis();
+
+    doc["current"]  = cur;
+    doc["switches"] = switch_cnt;
+
+    JsonArray arr = doc["brokers"].to<JsonArray>();
+
+    FOR(i, 0, cnt) {
+        JsonObject obj = arr.add<JsonObject>();
+
+        obj["address"] = list[i].ep.address;
+        obj["port"]    = list[i].ep.port;
+        obj["rtt_ms"]  = list[i].rtt_ms;
+        obj["fails"]   = list[i].fail_cnt;
+        obj["down"]    = !isHealthy(i, now);
+    }
+
+    serializeJson(doc, msg);
+
+    return msg;
+}
+
+#endif
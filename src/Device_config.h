@@ -0,0 +1,234 @@
+#ifndef DEVICE_CONFIG_H
+#define DEVICE_CONFIG_H
+
+/* 개요: 기기를 어떤 모듈로 구성할지 컴파일 시점에 조립하는 헤더 입니다.
+ * --------------------------------------------
+ * 1. 각 모듈은 static 함수만 가진 정책(policy) 구조체로, Device<...> 템플릿 인자로 조립합니다
+ *    - 네트워크 ( TLS_on / TLS_off )
+ *    - LED     ( LED_on / LED_off )          : LED_handler.h
+ *    - FTP     ( FTP_on / FTP_off )          : FTP_handler.h
+ *    - 로그     ( Log_serial / Log_off )      : Log_config.h
+ *    - 텔레메트리 ( Scan_report_on / Scan_report_off ) : 스캔 결과 출력 및 전송
+ *    - 파일 전송 ( FT_on / FT_off )           : File_transfer.h
+ *    - OTA     ( OTA_on / OTA_off )          : OTA_handler.h
+ *    - RPC     ( Rpc_on / Rpc_off )          : Rpc_handler.h
+ *    - 샘플러   ( Sample_on / Sample_off )    : Sampler.h
+ *    - 집계     ( Agg_on / Agg_off )          : Aggregator.h
+ *    - 압축     ( Zip_on / Zip_off )          : Stream_compressor.h
+ * 2. 호출부는 Dev::Led::connected() 처럼 부르며, 컴파일 시점에 결정되므로 가상함수/함수포인터 비용이 없습니다
+ * 3. _off 정책은 빈 inline 함수라 호출 자체가 사라집니다
+ *    - _on 정책만 모듈 객체를 GetInstance()로 처음 사용할 때 만들기 때문에, _off 구성에는 버퍼/태스크/큐가 생기지 않습니다
+ *    - 그래서 모듈 헤더에는 전역 참조( ex: File_transfer& ft )를 두지 않습니다 ( 전역 참조가 있으면 항상 생성됨 )
+ * 4. 구성은 platformio.ini 의 build_flags 로 고릅니다 ( 없으면 DEVICE_DEFAULT )
+ *    - DEVICE_FULL    : 모든 모듈 ( FTP 서버, 샘플러 포함 )
+ *    - DEVICE_DEFAULT : FTP 서버, 샘플러 제외
+ *    - DEVICE_MINIMAL : WiFi + MQTT 만 ( LED, FTP, 로그, 스캔 전송, 파일 전송, OTA, RPC, 샘플러, 집계, 압축 제외, TLS 없이 접속 )
+ *    - DEVICE_SIM     : 호스트 시뮬레이터용 ( test/test_fleet, DEVICE_MINIMAL 에 스캔 전송만 추가 )
+ * 5. 빌드 시 구성별 flash / static RAM 크기는 scripts/size_report.py 가 출력하고, 부팅 시간은 setup() 끝에 출력합니다
+*/
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <Log_config.h>
+
+///////////////////////////////////// 네트워크
+
+// TLS로 브로커 접속 ( 인증서 검증 안함 )
+struct TLS_on {
+    typedef WiFiClientSecure Client;
+
+    static void setup(Client& client) { client.setInsecure(); }
+};
+
+// 평문으로 브로커 접속
+struct TLS_off {
+    typedef WiFiClient Client;
+
+    static void setup(Client& client) {}
+};
+
+///////////////////////////////////// LED ( LED_on 은 LED_handler.h )
+
+struct LED_off {
+    static void init() {}
+    static void run() {}
+    static void scanning() {}
+    static void connecting() {}
+    static void connected() {}
+    static void failed() {}
+};
+
+///////////////////////////////////// FTP ( FTP_on 은 FTP_handler.h )
+
+struct FTP_off {
+    static void begin() {}
+    static void run() {}
+};
+
+///////////////////////////////////// 텔레메트리
+
+// 스캔 결과를 문자열로 만들어 출력 및 전송
+struct Scan_report_on {
+    static constexpr bool enabled = true;
+};
+
+// 스캔 결과는 접속할 AP 검색에만 사용
+struct Scan_report_off {
+    static constexpr bool enabled = false;
+};
+
+///////////////////////////////////// 파일 전송 ( FT_on 은 File_transfer.h )
+
+struct FT_off {
+    static constexpr size_t frame_size = 0;     // MQTT 수신 버퍼에 필요한 크기
+
+    template <typename F>
+    static void init(F sender) {}
+
+    template <typename C>
+    static void subscribe(C& client) {}
+
+    static bool handle(const char* topic, const uint8_t* payload, unsigned int length) { return false; }
+    static void run() {}
+};
+
+///////////////////////////////////// OTA ( OTA_on 은 OTA_handler.h )
+
+struct OTA_off {
+    static constexpr size_t frame_size = 0;
+
+    static void boot_check() {}
+    static bool pending() { return false; }
+
+    template <typename F>
+    static void init(F sender) {}
+
+    template <typename C>
+    static void subscribe(C& client) {}
+
+    static bool handle(const char* topic, const uint8_t* payload, unsigned int length) { return false; }
+    static void run(bool healthy) {}
+};
+
+///////////////////////////////////// RPC ( Rpc_on 은 Rpc_handler.h )
+
+struct Rpc_off {
+    template <typename F>
+    static void init(F sender) {}
+
+    template <typename F>
+    static void reg_method(const char* name, F fn) {}
+
+    template <typename C>
+    static void subscribe(C& client) {}
+
+    static bool handle(const char* topic, const uint8_t* payload, unsigned int length) { return false; }
+    static int inflight() { return 0; }
+    static void run() {}
+};
+
+///////////////////////////////////// 샘플러 ( Sample_on 은 Sampler.h )
+
+struct Sample_off {
+    static void init() {}
+
+    template <typename B>
+    static bool add_channel(B* bus, uint8_t len, uint8_t type = 0) { return false; }
+
+    static bool begin(uint32_t period_ms) { return false; }
+
+    static bool add_adc(uint8_t pin) { return false; }
+
+    template <typename V, typename F>
+    static void run(V on_value, F on_block) {}
+
+    static String stats() { return "sampler off"; }
+};
+
+///////////////////////////////////// 집계 ( Agg_on 은 Aggregator.h )
+
+struct Agg_off {
+    template <typename F>
+    static void init(F sender) {}
+
+    static int reg_metric(String name, uint32_t window_ms, uint8_t slices = 1) { return -1; }
+    static void add(int id, float v) {}
+    static String raw(String name) { return ""; }
+    static void run(uint32_t now) {}
+};
+
+///////////////////////////////////// 압축 ( Zip_on 은 Stream_compressor.h )
+
+struct Zip_off {
+    static constexpr bool enabled = false;
+
+    static size_t measure(const uint8_t* src, size_t len) { return len; }
+
+    template <typename F>
+    static bool stream(const uint8_t* src, size_t len, F sink) { return false; }
+};
+
+///////////////////////////////////// 조립
+
+template <typename NET, typename LED, typename FTP, typename LOG, typename SCAN,
+          typename FT, typename OTA, typename RPC, typename SAMPLE, typename AGG, typename ZIP>
+struct Device {
+    typedef NET    Net;
+    typedef LED    Led;
+    typedef FTP    Ftp;
+    typedef LOG    Log;
+    typedef SCAN   Scan;
+    typedef FT     Ft;
+    typedef OTA    Ota;
+    typedef RPC    Rpc;
+    typedef SAMPLE Sample;
+    typedef AGG    Agg;
+    typedef ZIP    Zip;
+
+    // hw_init() 이후 호출 ( 센서 채널은 이후 Dev::Sample::add_channel() 또는 add_adc(), Dev::Sample::begin() 으로 등록 )
+    static void init() {
+        Led::init();
+        Sample::init();
+    }
+
+    // loop() 에서 호출
+    static void run() { Led::run(); }
+};
+
+#if defined(DEVICE_MINIMAL)
+#define DEVICE_NAME "minimal"
+typedef Device<TLS_off, LED_off, FTP_off, Dev_log, Scan_report_off,
+               FT_off, OTA_off, Rpc_off, Sample_off, Agg_off, Zip_off> Dev;
+
+#elif defined(DEVICE_SIM)
+#define DEVICE_NAME "sim"
+typedef Device<TLS_off, LED_off, FTP_off, Dev_log, Scan_report_on,
+               FT_off, OTA_off, Rpc_off, Sample_off, Agg_off, Zip_off> Dev;
+
+#elif defined(DEVICE_FULL)
+#define DEVICE_NAME "full"
+#include <LED_handler.h>
+#include <FTP_handler.h>
+#include <File_transfer.h>
+#include <OTA_handler.h>
+#include <Rpc_handler.h>
+#include <Sampler.h>
+#include <Aggregator.h>
+#include <Stream_compressor.h>
+typedef Device<TLS_on, LED_on, FTP_on, Dev_log, Scan_report_on,
+               FT_on, OTA_on, Rpc_on, Sample_on, Agg_on, Zip_on> Dev;
+
+#else
+#define DEVICE_NAME "default"
+#include <LED_handler.h>
+#include <File_transfer.h>
+#include <OTA_handler.h>
+#include <Rpc_handler.h>
+#include <Aggregator.h>
+#include <Stream_compressor.h>
+typedef Device<TLS_on, LED_on, FTP_off, Dev_log, Scan_report_on,
+               FT_on, OTA_on, Rpc_on, Sample_off, Agg_on, Zip_on> Dev;
+#endif
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef FTP_HANDLER_H
+#define FTP_HANDLER_H
+
+/* 개요: LittleFS를 FTP로 접근하게 하는 헤더 입니다. ( Device_config.h 의 FTP 정책 )
+ * --------------------------------------------
+ * 1. DEVICE_FULL 구성에서만 포함되며, 다른 구성에서는 FtpServer 객체가 만들어지지 않습니다
+ * 2. WiFi 접속 후 LittleFS가 열리면 begin(), 접속 중에는 run()이 호출됩니다
+ * 3. 기본 파일 송수신은 MQTT로 처리합니다 ( File_transfer.h 참고 )
+*/
+
+#include <Arduino.h>
+#include <SimpleFTPServer.h>
+#include <Log_config.h>
+
+void _callback(FtpOperation ftpOperation, unsigned int freeSpace, unsigned int totalSpace);
+void _transferCallback(FtpTransferOperation ftpOperation, const char* name, unsigned int transferredSize);
+
+struct FTP_on {
+    // 처음 사용할 때 생성
+    static FtpServer& server() {
+        static FtpServer instance;
+
+        return instance;
+    }
+
+    static void begin() {
+        server().setCallback(_callback);
+        server().setTransferCallback(_transferCallback);
+        server().begin("admin", "1234");
+    }
+
+    static void run() { server().handleFTP(); }
+};
+
+void _callback(FtpOperation ftpOperation, unsigned int freeSpace, unsigned int totalSpace) {
+    switch (ftpOperation) {
+        case FTP_CONNECT:
+            Dev_log::println(F("FTP: Connected!"));
+            break;
+        case FTP_DISCONNECT:
+            Dev_log::println(F("FTP: Disconnected!"));
+            break;
+        case FTP_FREE_SPACE_CHANGE:
+            Dev_log::printf("FTP: Free space change, free %u of %u!\n", freeSpace, totalSpace);
+            break;
+        default:
+            break;
+  }
+}
+
+void _transferCallback(FtpTransferOperation ftpOperation, const char* name, unsigned int transferredSize) {
+  switch (ftpOperation) {
+    case FTP_UPLOAD_START:
+      Dev_log::println(F("FTP: Upload start!"));
+      break;
+    case FTP_UPLOAD:
+      Dev_log::printf("FTP: Upload of file %s byte %u\n", name, transferredSize);
+      break;
+    case FTP_TRANSFER_STOP:
+      Dev_log::println(F("FTP: Finish transfer!"));
+      break;
+    case FTP_TRANSFER_ERROR:
+      Dev_log::println(F("FTP: Transfer error!"));
+      break;
+    default:
+      break;
+  }
+}
+
+#endif
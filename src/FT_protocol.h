@@ -0,0 +1,87 @@
+#ifndef FT_PROTOCOL_H
+#define FT_PROTOCOL_H
+
+/* 개요: 파일 전송 / OTA 가 함께 쓰는 프레임 형식을 담은 헤더 입니다.
+ * --------------------------------------------
+ * 1. 프레임 형식과 각 op의 의미는 File_transfer.h, OTA_handler.h 참고
+ * 2. Arduino에 의존하지 않으므로 호스트(테스트, 송신 도구)에서도 그대로 include 할 수 있습니다
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FT_CHUNK_SIZE  1024
+#define FT_HEADER_SIZE 11
+
+enum FT_op {
+    FT_OP_PUT    = 1,
+    FT_OP_GET    = 2,
+    FT_OP_DATA   = 3,
+    FT_OP_ACK    = 4,
+    FT_OP_COMMIT = 5,
+    FT_OP_ABORT  = 6
+};
+
+enum FT_status {
+    FT_OK           = 0,
+    FT_ERR_CRC      = 1,
+    FT_ERR_OFFSET   = 2,
+    FT_ERR_IO       = 3,
+    FT_ERR_STATE    = 4,
+    FT_ERR_SIZE     = 5,
+    FT_ERR_PATH     = 6,    // "/" 로 시작하지 않거나 ".." 이 들어간 경로
+    FT_ERR_TIMEOUT  = 7     // 상대가 응답하지 않아 세션 정리 ( 기기→호스트 ABORT )
+};
+
+// 프레임 헤더
+typedef struct FT_frame {
+    uint8_t  op;
+    uint8_t  id;
+    uint8_t  status;
+    uint32_t offset;
+    uint32_t crc;
+    const uint8_t* data;
+    size_t   len;
+} FT_frame;
+
+// CRC32 ( IEEE 802.3 ), 이어서 계산할 땐 이전 결과를 crc로 넘김
+uint32_t ft_crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+
+    return ~crc;
+}
+
+// 수신 데이터를 프레임으로 해석 ( 헤더보다 짧으면 false )
+bool ft_parse(const uint8_t* payload, size_t length, FT_frame& frame) {
+    if (length < FT_HEADER_SIZE) return false;
+
+    frame.op     = payload[0];
+    frame.id     = payload[1];
+    frame.status = payload[2];
+    frame.offset = ((uint32_t)payload[3] << 24) | ((uint32_t)payload[4] << 16) | ((uint32_t)payload[5] << 8) | payload[6];
+    frame.crc    = ((uint32_t)payload[7] << 24) | ((uint32_t)payload[8] << 16) | ((uint32_t)payload[9] << 8) | payload[10];
+    frame.data   = payload + FT_HEADER_SIZE;
+    frame.len    = length - FT_HEADER_SIZE;
+
+    return true;
+}
+
+// 프레임 헤더 작성
+void ft_header(uint8_t* out, uint8_t op, uint8_t id, uint8_t status, uint32_t offset, uint32_t crc) {
+    out[0]  = op;
+    out[1]  = id;
+    out[2]  = status;
+    out[3]  = offset >> 24; out[4]  = offset >> 16; out[5]  = offset >> 8; out[6]  = offset;
+    out[7]  = crc >> 24;    out[8]  = crc >> 16;    out[9]  = crc >> 8;    out[10] = crc;
+}
+
+#endif
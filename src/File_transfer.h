@@ -0,0 +1,452 @@
+#ifndef FILE_TRANSFER_H
+#define FILE_TRANSFER_H
+
+/* 개요: MQTT를 통해 LittleFS의 파일을 주고받는 헤더 입니다. ( FTP 대체 )
+ * --------------------------------------------
+ * 1. "ft/<기기이름>/in" 으로 요청을 받고 "ft/<기기이름>/out" 으로 응답합니다
+ * 2. 청크 단위로 전송하며 청크마다 CRC32를 검사합니다
+ * 3. 응답(ACK)을 기다리지 않고 FT_WINDOW 개 까지 연속으로 전송합니다 ( go-back-N )
+ * 4. 수신 중인 파일은 "<경로>.part" 에 바로 기록하고, 완료(COMMIT) 시 검증 후 rename 합니다
+ * 5. 끊긴 뒤 같은 경로로 다시 PUT 하면 .part 크기부터 이어받습니다 ( GET은 시작 오프셋 지정 )
+ *    - PUT의 파일 CRC와 크기를 "<경로>.part.crc" 에 함께 저장하고, 둘 다 같을 때만 이어받습니다
+ *    - 다른 내용의 파일로 PUT 하면 .part 를 지우고 처음부터 받습니다
+ * 6. 호스트가 사라지면 세션을 정리하고 ABORT(FT_ERR_TIMEOUT)를 보냅니다 ( 다음 전송을 막지 않도록 )
+ *    - GET: ACK 위치가 늘지 않은 채 FT_MAX_RETRY 번 연속으로 재전송 시간 초과
+ *    - PUT: FT_IDLE_TIMEOUT 동안 아무 프레임도 받지 못함 ( .part 는 이어받기를 위해 남겨둠 )
+ * 7. 경로는 "/" 로 시작해야 하며 ".." 이 들어가면 거부합니다 ( FT_ERR_PATH )
+ *
+ * 프레임 형식 ( 빅엔디안 )
+ * --------------------------------------------
+ * [op 1][id 1][status 1][offset 4][crc 4][data ...]
+ * - PUT    (호스트→기기) offset: 전체 크기, crc: 파일 CRC, data: 경로 → ACK offset: 이어받을 위치
+ * - GET    (호스트→기기) offset: 시작 위치, data: 경로          → ACK offset: 파일 크기, crc: 파일 CRC
+ * - DATA   (양방향)     offset: 청크 위치, crc: 청크 CRC, data: 청크
+ * - ACK    (양방향)     offset: 다음에 받을 위치, status: 결과
+ * - COMMIT (호스트→기기) crc: 파일 전체 CRC                     → ACK status: 결과
+ * - ABORT  (양방향)     전송 취소 ( .part 는 이어받기를 위해 남겨둠, 기기→호스트는 status: FT_ERR_TIMEOUT )
+*/
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <env.h>
+#include <Log_config.h>
+#include <FT_protocol.h>
+#include <functional>
+
+#define FT_WINDOW      4
+#define FT_TIMEOUT     3000   // GET 중 ACK가 없으면 마지막 ACK 위치부터 재전송 ( ms )
+#define FT_MAX_RETRY   5      // GET 중 ACK 위치가 늘지 않은 채 연속으로 재전송하면 세션 정리
+#define FT_IDLE_TIMEOUT 30000 // PUT 중 이 시간 동안 프레임이 없으면 세션 정리 ( ms )
+
+// 프레임 송신 함수 ( 인자: 토픽, 헤더, 헤더 길이, 데이터, 데이터 길이 )
+typedef std::function<void(const char*, const uint8_t*, size_t, const uint8_t*, size_t)> FT_sender;
+
+// 프레임의 데이터를 문자열로 ( 경로 등, NUL 종료가 보장되지 않으므로 길이만큼만 )
+String ft_string(FT_frame& frame) {
+    String str;
+
+    for (size_t i = 0; i < frame.len; i++) str += (char)frame.data[i];
+
+    return str;
+}
+
+class File_transfer {
+    private:
+        enum { IDLE, PUT, GET } state;
+        uint8_t  id;
+        String   path;
+        File     file;
+        uint32_t total;       // PUT: 전체 크기, GET: 파일 크기
+        uint32_t crc;         // PUT: 받을 파일의 CRC
+        uint32_t next;        // PUT: 다음에 받을 위치, GET: 다음에 보낼 위치
+        uint32_t acked;       // GET: 호스트가 받았다고 확인한 위치
+        uint32_t last_rx_ms;  // GET: 마지막 ACK 수신 시각, PUT: 마지막 프레임 수신 시각
+        uint8_t  retry;       // GET: ACK 위치가 늘지 않은 채 연속으로 재전송한 횟수
+        uint8_t  chunk[FT_CHUNK_SIZE];
+
+        String in_topic;
+        String out_topic;
+        FT_sender sender;
+
+        void reply(uint8_t op, uint8_t status, uint32_t offset, uint32_t crc = 0, const uint8_t* data = nullptr, size_t len = 0);
+        void close();
+        void expire();
+        static bool valid_path(const String& file_path);
+        uint32_t file_crc(String file_path);
+        bool part_matches(String part);
+        void save_part_info(String part);
+
+        void on_put(FT_frame& frame);
+        void on_get(FT_frame& frame);
+        void on_data(FT_frame& frame);
+        void on_ack(FT_frame& frame);
+        void on_commit(FT_frame& frame);
+
+    public:
+        File_transfer() = default;
+        File_transfer& operator=(const File_transfer& ref) = delete;
+        static File_transfer& GetInstance();
+
+        // 초기화 ( 응답을 내보낼 함수 등록 )
+        void init(FT_sender sender);
+
+        // 구독할 토픽
+        String getTopic() { return in_topic; }
+
+        // 수신 메시지 처리 ( 파일 전송 토픽이 아니면 false )
+        bool handle(const char* topic, const uint8_t* payload, unsigned int length);
+
+        // non-blocking 실행 ( GET 전송 및 재전송, 응답 없는 세션 정리 )
+        void run();
+};
+
+File_transfer& File_transfer::GetInstance() {
+    static File_transfer instance;
+
+    return instance;
+}
+
+// 초기화 ( 응답을 내보낼 함수 등록 )
+void File_transfer::init(FT_sender sender) {
+    this->sender = sender;
+    in_topic  = "ft/" + env.getName() + "/in";
+    out_topic = "ft/" + env.getName() + "/out";
+    state = IDLE;
+}
+
+void File_transfer::reply(uint8_t op, uint8_t status, uint32_t offset, uint32_t crc, const uint8_t* data, size_t len) {
+    uint8_t header[FT_HEADER_SIZE];
+
+    ft_header(header, op, id, status, offset, crc);
+    sender(out_topic.c_str(), header, FT_HEADER_SIZE, data, len);
+}
+
+void File_transfer::close() {
+    if (file) file.close();
+
+    state = IDLE;
+}
+
+// 호스트가 응답하지 않는 세션 정리 ( 호스트에 ABORT로 알림 )
+void File_transfer::expire() {
+    Dev_log::printf("[FT] %s 응답 없음, 세션 정리\n", path.c_str());
+
+    reply(FT_OP_ABORT, FT_ERR_TIMEOUT, state == GET ? acked : next);
+    close();
+}
+
+// "/" 로 시작하고 ".." 이 없는 경로만 허용
+bool File_transfer::valid_path(const String& file_path) {
+    return file_path.startsWith("/") && file_path.indexOf("..") < 0;
+}
+
+// 파일 전체의 CRC32를 스트리밍으로 계산
+uint32_t File_transfer::file_crc(String file_path) {
+    File f = LittleFS.open(file_path, FILE_READ);
+    uint32_t crc = 0;
+
+    if (!f) return 0;
+
+    while (f.available()) {
+        size_t len = f.read(chunk, FT_CHUNK_SIZE);
+        crc = ft_crc32(chunk, len, crc);
+    }
+
+    f.close();
+
+    return crc;
+}
+
+// .part 가 지금 받을 파일( crc, total )의 일부인지 ( .part.crc 로 확인 )
+bool File_transfer::part_matches(String part) {
+    File f = LittleFS.open(part + ".crc", FILE_READ);
+    uint32_t info[2];
+
+    if (!f) return false;
+
+    bool ok = f.read((uint8_t*)info, sizeof(info)) == sizeof(info);
+    f.close();
+
+    return ok && info[0] == crc && info[1] == total;
+}
+
+// 받을 파일의 crc, total 저장 ( 다음 PUT 에서 이어받기 판단용 )
+void File_transfer::save_part_info(String part) {
+    File f = LittleFS.open(part + ".crc", FILE_WRITE);
+    uint32_t info[2] = { crc, total };
+
+    if (!f) return;
+
+    f.write((const uint8_t*)info, sizeof(info));
+    f.close();
+}
+
+// 수신 메시지 처리 ( 파일 전송 토픽이 아니면 false )
+bool File_transfer::handle(const char* topic, const uint8_t* payload, unsigned int length) {
+    if (in_topic != topic) return false;
+
+    FT_frame frame;
+
+    if (!ft_parse(payload, length, frame)) {
+        Dev_log::println("[FT] 잘못된 프레임");
+        return true;
+    }
+
+    // 새 세션 시작은 항상 허용, 그 외에는 현재 세션의 id만 처리
+    if (frame.op != FT_OP_PUT && frame.op != FT_OP_GET && (state == IDLE || frame.id != id)) {
+        // 완료 후 늦게 도착한 ACK는 조용히 무시
+        if (frame.op == FT_OP_ACK) return true;
+
+        uint8_t prev_id = id;
+
+        id = frame.id;
+        reply(FT_OP_ACK, FT_ERR_STATE, 0);
+        id = prev_id;
+
+        return true;
+    }
+
+    switch (frame.op) {
+        case FT_OP_PUT:    on_put(frame);    break;
+        case FT_OP_GET:    on_get(frame);    break;
+        case FT_OP_DATA:   on_data(frame);   break;
+        case FT_OP_ACK:    on_ack(frame);    break;
+        case FT_OP_COMMIT: on_commit(frame); break;
+        case FT_OP_ABORT:
+            Dev_log::printf("[FT] %s 취소\n", path.c_str());
+            close();
+            break;
+        default:
+            break;
+    }
+
+    return true;
+}
+
+void File_transfer::on_put(FT_frame& frame) {
+    close();
+
+    id    = frame.id;
+    path  = ft_string(frame);
+    total = frame.offset;
+    crc   = frame.crc;
+
+    if (!valid_path(path)) {
+        reply(FT_OP_ACK, FT_ERR_PATH, 0);
+        return;
+    }
+
+    if (LittleFS.totalBytes() - LittleFS.usedBytes() < total) {
+        reply(FT_OP_ACK, FT_ERR_SIZE, 0);
+        return;
+    }
+
+    String part = path + ".part";
+
+    // 이전에 받다 만 파일이 같은 파일( CRC, 크기 )이면 그 위치부터, 아니면 처음부터
+    if (!part_matches(part)) {
+        LittleFS.remove(part);
+        save_part_info(part);
+    }
+
+    file = LittleFS.open(part, FILE_APPEND, true);
+
+    if (!file) {
+        reply(FT_OP_ACK, FT_ERR_IO, 0);
+        return;
+    }
+
+    next = file.size();
+
+    if (total < next) {
+        file.close();
+        LittleFS.remove(part);
+        file = LittleFS.open(part, FILE_APPEND, true);
+        next = 0;
+    }
+
+    Dev_log::printf("[FT] PUT %s (%u/%ubyte)\n", path.c_str(), next, total);
+
+    last_rx_ms = millis();
+    state = PUT;
+    reply(FT_OP_ACK, FT_OK, next);
+}
+
+void File_transfer::on_get(FT_frame& frame) {
+    close();
+
+    id   = frame.id;
+    path = ft_string(frame);
+
+    if (!valid_path(path)) {
+        reply(FT_OP_ACK, FT_ERR_PATH, 0);
+        return;
+    }
+
+    file = LittleFS.open(path, FILE_READ);
+
+    if (!file) {
+        reply(FT_OP_ACK, FT_ERR_IO, 0);
+        return;
+    }
+
+    total = file.size();
+    next = acked = std::min(frame.offset, total);
+    last_rx_ms = millis();
+    retry = 0;
+
+    Dev_log::printf("[FT] GET %s (%u/%ubyte)\n", path.c_str(), next, total);
+
+    // 호스트가 마지막에 전체를 검증할 수 있도록 파일 CRC를 함께 알려줌
+    uint32_t crc = file_crc(path);
+
+    state = GET;
+    reply(FT_OP_ACK, FT_OK, total, crc);
+}
+
+void File_transfer::on_data(FT_frame& frame) {
+    if (state != PUT) {
+        reply(FT_OP_ACK, FT_ERR_STATE, 0);
+        return;
+    }
+
+    last_rx_ms = millis();
+
+    // 순서가 어긋난 청크는 버리고 받아야 할 위치를 알려줌 ( 호스트는 그 위치부터 재전송 )
+    if (frame.offset != next) {
+        reply(FT_OP_ACK, FT_ERR_OFFSET, next);
+        return;
+    }
+
+    if (ft_crc32(frame.data, frame.len) != frame.crc) {
+        reply(FT_OP_ACK, FT_ERR_CRC, next);
+        return;
+    }
+
+    if (total < next + frame.len) {
+        reply(FT_OP_ACK, FT_ERR_SIZE, next);
+        return;
+    }
+
+    // 수신 버퍼에서 바로 플래시에 기록 ( 별도 버퍼링 없음 )
+    if (file.write(frame.data, frame.len) != frame.len) {
+        reply(FT_OP_ACK, FT_ERR_IO, next);
+        return;
+    }
+
+    next += frame.len;
+
+    reply(FT_OP_ACK, FT_OK, next);
+}
+
+void File_transfer::on_ack(FT_frame& frame) {
+    if (state != GET) return;
+
+    last_rx_ms = millis();
+
+    if (total < frame.offset) return;
+
+    // 정상 ACK면 창을 밀고, 오류면 해당 위치부터 재전송
+    if (frame.status == FT_OK && acked < frame.offset) {
+        acked = frame.offset;
+        retry = 0;
+    }
+    if (frame.status != FT_OK) next = acked = frame.offset;
+
+    if (acked == total) {
+        Dev_log::printf("[FT] GET %s 완료\n", path.c_str());
+        close();
+    }
+}
+
+void File_transfer::on_commit(FT_frame& frame) {
+    if (state != PUT) {
+        reply(FT_OP_ACK, FT_ERR_STATE, 0);
+        return;
+    }
+
+    file.close();
+
+    String part = path + ".part";
+
+    if (next != total) {
+        file = LittleFS.open(part, FILE_APPEND, true);
+        reply(FT_OP_ACK, FT_ERR_SIZE, next);
+        return;
+    }
+
+    // 전체 CRC가 틀리면 처음부터 다시 받아야 하므로 .part 삭제
+    if (file_crc(part) != frame.crc) {
+        LittleFS.remove(part);
+        LittleFS.remove(part + ".crc");
+        reply(FT_OP_ACK, FT_ERR_CRC, 0);
+        state = IDLE;
+        return;
+    }
+
+    if (!LittleFS.rename(part, path)) {
+        reply(FT_OP_ACK, FT_ERR_IO, next);
+        state = IDLE;
+        return;
+    }
+
+    LittleFS.remove(part + ".crc");
+
+    Dev_log::printf("[FT] PUT %s 완료\n", path.c_str());
+
+    state = IDLE;
+    reply(FT_OP_ACK, FT_OK, next);
+}
+
+// non-blocking 실행 ( GET 전송 및 재전송, 응답 없는 세션 정리 )
+void File_transfer::run() {
+    // COMMIT/ABORT 없이 끊긴 PUT은 파일을 닫고 정리
+    if (state == PUT && FT_IDLE_TIMEOUT < millis() - last_rx_ms) {
+        expire();
+        return;
+    }
+
+    if (state != GET) return;
+
+    // ACK가 끊기면 마지막으로 확인된 위치부터 다시 전송 ( 진전 없이 계속 끊기면 정리 )
+    if (FT_TIMEOUT < millis() - last_rx_ms) {
+        if (FT_MAX_RETRY <= ++retry) {
+            expire();
+            return;
+        }
+
+        next = acked;
+        last_rx_ms = millis();
+    }
+
+    // 창 크기만큼만 미리 전송 ( loop 1회에 청크 1개씩 )
+    if (next < total && next < acked + FT_WINDOW * FT_CHUNK_SIZE) {
+        file.seek(next);
+
+        size_t len = file.read(chunk, std::min((uint32_t)FT_CHUNK_SIZE, total - next));
+
+        reply(FT_OP_DATA, FT_OK, next, ft_crc32(chunk, len), chunk, len);
+
+        next += len;
+    }
+}
+
+// Device_config.h 의 파일 전송 정책
+struct FT_on {
+    static constexpr size_t frame_size = FT_HEADER_SIZE + FT_CHUNK_SIZE;
+
+    static void init(FT_sender sender) { File_transfer::GetInstance().init(sender); }
+
+    template <typename C>
+    static void subscribe(C& client) { client.subscribe(File_transfer::GetInstance().getTopic().c_str()); }
+
+    // 파일 전송 프레임은 바이너리이므로 문자열로 바꾸지 않고 바로 처리
+    static bool handle(const char* topic, const uint8_t* payload, unsigned int length) {
+        return File_transfer::GetInstance().handle(topic, payload, length);
+    }
+
+    static void run() { File_transfer::GetInstance().run(); }
+};
+
+#endif
@@ -2,17 +2,15 @@
 #define HW_CONFIG_H
 
 #include <Arduino.h>
-#include <LED_handler.h>
 
 #define BUILTIN_LED 2
 #define dW digitalWrite
 
+#define SAMPLE_ADC_PIN    34    // 샘플러 ch0 ( ADC1, 입력 전용 핀 )
+#define SAMPLE_PERIOD_MS  10    // 샘플러 주기 ( 100Hz )
+
 void hw_init() {
     pinMode(BUILTIN_LED, OUTPUT); dW(BUILTIN_LED, LOW);
-    
-    #ifdef LED_HANDLER_H
-    led.init();
-    #endif
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -93,4 +93,22 @@ void LED_handler::run() {
 
 LED_handler& led = LED_handler::GetInstance();
 
+// Device_config.h 의 LED 정책 ( 네트워크 상태별 점멸 패턴 )
+struct LED_on {
+    static void init() { led.init(); }
+    static void run() { led.run(); }
+    
+    // 스캔 중: 0.5초 간격 점멸
+    static void scanning() { led.set(500, NOT_USE_BLINK); }
+    
+    // 연결 시도 중: 빠르게 점멸
+    static void connecting() { led.set(100, NOT_USE_BLINK); }
+    
+    // 연결됨: 5초에 100ms씩 2번 점멸
+    static void connected() { led.set(5000, 100, 2); }
+    
+    // 사용 가능한 AP 없음, 연결 실패, 연결 해제: 2초에 50ms씩 5번 점멸
+    static void failed() { led.set(2000, 50, 5); }
+};
+
 #endif
\ No newline at end of file
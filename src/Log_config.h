@@ -0,0 +1,50 @@
+#ifndef LOG_CONFIG_H
+#define LOG_CONFIG_H
+
+/* 개요: 로그 출력 정책을 정하는 헤더 입니다. ( Device_config.h 의 로그 정책 )
+ * --------------------------------------------
+ * 1. 모든 모듈은 Serial 대신 Dev_log 로 출력합니다
+ * 2. env.h 처럼 Device_config.h 보다 먼저 포함되는 모듈에서도 쓸 수 있도록 따로 분리했습니다
+ * 3. DEVICE_MINIMAL 구성은 Log_off 라 출력 코드와 문자열 상수가 모두 빠집니다
+ * 4. DEVICE_SIM( 호스트 시뮬레이터 )도 기기 수천개가 한꺼번에 출력하지 않도록 Log_off 입니다
+*/
+
+#include <Arduino.h>
+
+// 시리얼로 출력
+struct Log_serial {
+    static void begin(unsigned long baud) { Serial.begin(baud); }
+    static void flush() { Serial.flush(); }
+
+    template <typename T>
+    static void print(T v) { Serial.print(v); }
+
+    template <typename T>
+    static void println(T v) { Serial.println(v); }
+
+    template <typename... Args>
+    static void printf(const char* fmt, Args... args) { Serial.printf(fmt, args...); }
+};
+
+// 출력 안함 ( 시리얼 초기화도 생략 )
+struct Log_off {
+    static void begin(unsigned long baud) {}
+    static void flush() {}
+
+    template <typename T>
+    static void print(T v) {}
+
+    template <typename T>
+    static void println(T v) {}
+
+    template <typename... Args>
+    static void printf(const char* fmt, Args... args) {}
+};
+
+#if defined(DEVICE_MINIMAL) || defined(DEVICE_SIM)
+typedef Log_off Dev_log;
+#else
+typedef Log_serial Dev_log;
+#endif
+
+#endif
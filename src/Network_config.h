@@ -6,31 +6,64 @@
  * 1. 주변 WiFi를 스캔 후, LittleFS에 저장된 WiFi정보로 자동 접속합니다
  * 2. 저장되있는 WiFI정보에서 Password가 틀릴 시 자동으로 차단 합니다
  * 3. WiFi에 접속 성공 시 MQTT서버에 접속합니다
- * 4. WiFi에 접속 성공 시 FTP를 구축합니다
+ * 4. WiFi에 접속 성공 시 FTP를 구축합니다 ( DEVICE_FULL 구성에서만, Device_config.h 참고 )
+ * 5. LittleFS 파일 송수신은 MQTT로 처리합니다 ( File_transfer.h 참고, Dev::Ft )
+ * 6. 펌웨어 업데이트(OTA)도 MQTT로 처리합니다 ( OTA_handler.h 참고, Dev::Ota )
+ * 7. id로 요청/응답을 짝 맞추는 RPC를 지원합니다 ( Rpc_handler.h 참고, Dev::Rpc )
+ * 8. MQTT 재접속은 MQTT_RETRY_MS 마다 시도합니다
+ * 9. 접속/전송 횟수와 지연시간을 기록합니다 ( getStats(), 접속 지연시간은 성공한 접속만 )
+ * 10. 브로커가 여러개면 가장 빠른 브로커로 접속하고, 연속 실패 시 다음 브로커로 넘어갑니다 ( Broker_selector.h 참고 )
+ * 11. 펌웨어에서는 전역 net 하나만 쓰지만, 설정(EnvData)을 넘겨 여러 개 만들 수 있습니다
+ *     - 호스트의 기기 다수 시뮬레이터( test/test_fleet )가 기기마다 하나씩 만들어 사용
+ *     - 브로커 선택 상태와 MQTT 수신 콜백도 인스턴스 별로 가짐 ( 형식 협상( codec )은 전역 공유 )
 */
 
 #include <Arduino.h>
 #include <WiFi.h>
 #include <env.h>
-#include <WiFiclientSecure.h>
+#include <Device_config.h>
 #include <SimpleTimer.h>
 #include <PubSubclient.h>
-#include <SimpleFTPServer.h>
+#include <Payload_codec.h>
+#include <Stream_compressor.h>
+#include <Broker_selector.h>
+#include <algorithm>
 #include <queue>
+#include <vector>
 #define FOR(i, b, e) for(int i = b; i < e; i++)
 
 #define AUTH_WRONG -1
 #define FAILED -1
 #define MQTT_MSG_QUEUE_SIZE 4
+#define MQTT_MSG_KEEP_SIZE 256 // 연결 해제 중 보관할 수 있는 메시지 최대 크기
 #define MQTT_MSG_CHUNK_SIZE 512
+#define MQTT_BUFFER_SIZE (std::max(Dev::Ft::frame_size, Dev::Ota::frame_size) + 256)  // 수신 버퍼 ( 파일 청크 + 헤더 + 토픽 )
+#define MQTT_RETRY_MS 2000     // MQTT 재접속 간격
 
 const char* ntpServer          = "pool.ntp.org";
 const long  gmtOffset_sec      = 9*3600;
 const int   daylightOffset_sec = 0;
 
-void _callback(FtpOperation ftpOperation, unsigned int freeSpace, unsigned int totalSpace);
-void _transferCallback(FtpTransferOperation ftpOperation, const char* name, unsigned int transferredSize);
-void mqtt_callback(char* topic, uint8_t* payload, unsigned int length);
+// 접속/전송 통계 ( 지연시간은 ms )
+typedef struct Net_stats {
+    uint32_t wifi_connects;
+    uint32_t wifi_connect_ms;     // 마지막 WiFi 접속에 걸린 시간
+    uint32_t mqtt_attempts;
+    uint32_t mqtt_fails;
+    uint32_t mqtt_connect_ms;     // 마지막으로 성공한 MQTT 접속에 걸린 시간
+    uint32_t mqtt_connect_max_ms; // 성공한 MQTT 접속 중 가장 오래 걸린 시간
+    uint32_t pub_cnt;
+    uint32_t pub_bytes;
+    uint32_t pending_flushed;     // 재접속 시 전송한 보관 메시지 수
+    uint32_t dropped;
+} Net_stats;
+
+// 연결 해제 중 보관하는 메시지 ( 협상된 형식으로 인코딩한 그대로 보관, 접두사 제외 )
+typedef struct Pending_msg {
+    String  topic;
+    uint8_t format;             // Payload_format ( FMT_TEXT: 문자열, FMT_MSGPACK: 바이너리 )
+    std::vector<uint8_t> body;
+} Pending_msg;
 
 typedef struct Wifi_info {
     String ssid;
@@ -41,6 +74,9 @@ typedef struct Wifi_info {
 
 class Network_Handler {
     private:
+        EnvData& env;       // 이 기기의 설정 ( 펌웨어는 전역 env )
+        Broker_selector broker;
+        
         Wifi_info current_info;
         Wifi_info scaned_list[32];
         String mqtt_recv;
@@ -49,29 +85,59 @@ class Network_Handler {
         bool isConnecting;  // 연결 시도 중을 명시적으로 표현하기 위해 생성
         bool isDEBUG_mode;
         int16_t wifi_cnt;
+        int16_t scan_cnt;   // scaned_list 에 채운 개수 ( 최대 32 )
+        uint32_t scan_seq;  // 스캔 결과를 갱신할 때마다 증가 ( 출력/전송 여부와 무관 )
+        String last_scan_log;
+        
+        Net_stats stats;
+        uint32_t wifi_begin_ms;   // WiFi.begin 호출 시각
         
         SimpleTimer reScanTimer;
         SimpleTimer connectingTimer;
         SimpleTimer reconnectMQTT_Timer;
         SimpleTimer connect_timeout_Timer;
 
-        WiFiClientSecure espclient;
+        Dev::Net::Client espclient;  // 구성에 따라 TLS 또는 평문
         PubSubClient mqtt_client;
         
-        FtpServer ftpSrv;
-        
         // WiFi에 연결 or 끊겼을 때 동작시킬 외부 함수 ( 콜백 )
         std::vector<std::function<void()>> onConnect_cb_list;
         std::vector<std::function<void()>> onDisconnect_cb_list;
         
         // MQTT브로커 서버에 연결되지 않았을 때 메시지 임시 저장소
-        std::queue<std::pair<String, String>> pending_msgs;
+        std::queue<Pending_msg> pending_msgs;
+        
+        // 압축 헤더를 붙여 스트리밍 압축 전송 ( 길이를 먼저 알아야 하므로 2번 압축 )
+        bool publish_compressed(String topic, const char* name_prefix, String *msg);
+        
+        // MQTT 수신 처리
+        void on_message(char* topic, uint8_t* payload, unsigned int length);
         
     public:
-        Network_Handler() = default;
+        explicit Network_Handler(EnvData& env) : env(env) {}
+        Network_Handler(const Network_Handler& ref) = delete;
         Network_Handler& operator=(const Network_Handler& ref) = delete;  
         static Network_Handler& GetInstance();
         String getSSID() { return current_info.ssid; }
+        String getPassword() { return current_info.password; }
+        String getLastScan() { return last_scan_log; }
+        uint32_t getScanSeq() { return scan_seq; }
+        
+        // 마지막 스캔 결과 ( Scan_report 구성과 무관하게 항상 갱신됨 )
+        int16_t getScanCount() { return scan_cnt; }
+        const Wifi_info& getScanResult(int16_t i) { return scaned_list[i]; }
+        
+        // 접속/전송 통계 ( JSON 문자열 )
+        String getStats();
+        
+        // 접속/전송 통계 ( 값 그대로 )
+        const Net_stats& getNetStats() { return stats; }
+        
+        // 브로커별 상태 ( JSON 문자열 )
+        String getBrokerStats() { return broker.stats(); }
+        
+        // 압축률 및 압축 비용 측정 ( 출력용 문자열 반환 )
+        String compress_bench(String name, String *msg);
         
         // 와이파이가 연결되었을 때 호출 시키고 싶은 함수를 등록 ( 반환형: void, 인자: void )
         void reg_connected_callback(std::function<void()> cb_func);
@@ -79,8 +145,8 @@ class Network_Handler {
         // 와이파이가 연결해제 됐을 때 호출 시키고 싶은 함수를 등록 ( 반환형: void, 인자: void )
         void reg_disconnected_callback(std::function<void()> cb_func);
         
-        // 초기화
-        void init();
+        // 초기화 ( scan: 초기 WiFi 스캔 여부, 절전 복귀 시엔 스캔 없이 fast_connect 사용 )
+        void init(bool scan = true);
 
         // 수신받은 데이터를 객체에 업데이트 ( 이때 상태 값도 업데이트 됨 )
         void set_mqtt_recv(String input);
@@ -102,6 +168,21 @@ class Network_Handler {
         
         // MQTT 브로커 서버에서 수신받은 데이터가 있는지 확인
         bool isAvailable() { return is_recv; }
+        
+        // MQTT 브로커 서버 연결 여부
+        bool isMqttConnected() { return mqtt_client.connected(); }
+        
+        // 보관중인 메시지 꺼내기 ( 없으면 false )
+        bool pop_pending(Pending_msg& msg);
+        
+        // 연결되면 보낼 메시지 보관 ( 큐가 찼거나 너무 길면 드랍하고 false )
+        bool push_pending(String topic, uint8_t format, const uint8_t* buf, size_t len);
+        
+        // 스캔 없이 알고있는 AP로 바로 연결 ( 채널, BSSID를 지정해 연결 시간 단축 )
+        void fast_connect(String ssid, String password, int32_t channel, const uint8_t* bssid);
+        
+        // 절전 전 MQTT, WiFi 연결 정리
+        void suspend();
 
         // WiFi 스캔 완료인지 확인
         bool isScanComplete() { return 0 <= wifi_cnt; }
@@ -114,11 +195,26 @@ class Network_Handler {
         
         // MQTT브로커 서버 설정
         void setMQTT();
+        
+        // 선택된 브로커로 서버 주소 변경
+        void apply_broker();
 
         // mqtt publish
         void publish(String topic, String msg);
         
-        void publish(String topic, String *msg);\
+        void publish(String topic, String *msg);
+        
+        // 바이너리 페이로드 publish ( 연결 해제 중일 땐 보관하지 않고 드랍 )
+        void publish(String topic, const uint8_t* buf, size_t len);
+        
+        // 접두사 없이 헤더+데이터를 그대로 publish ( 기기별 토픽용, 연결 해제 중일 땐 드랍 )
+        bool publish_raw(const char* topic, const uint8_t* head, size_t head_len, const uint8_t* body, size_t body_len);
+        
+        // 토픽에 협상된 형식으로 publish ( MSGPACK이면 doc, TEXT/ZIP이면 text를 전송, 연결 해제 중엔 해당 형식으로 보관 )
+        void publish(String topic, JsonDocument& doc, String text);
+        
+        // 자유 형식 문자열 publish ( MSGPACK이면 [SCHEMA_TEXT, text] 로 )
+        void publish_text(String topic, String text);
         
         // WiFi및 네트워크 설정들을 완전히 초기화
         void reset_network_setup();
@@ -129,7 +225,7 @@ class Network_Handler {
 }; Network_Handler& net = Network_Handler::GetInstance();
 
 Network_Handler& Network_Handler::GetInstance() {
-    static Network_Handler instance;
+    static Network_Handler instance(EnvData::GetInstance());
     
     return instance;
 }
@@ -143,20 +239,94 @@ void Network_Handler::reg_disconnected_callback(std::function<void()> cb_func) {
     onDisconnect_cb_list.push_back(cb_func);
 }
 
-// 초기화
-void Network_Handler::init() { 
+// 초기화 ( scan: 초기 WiFi 스캔 여부, 절전 복귀 시엔 스캔 없이 fast_connect 사용 )
+void Network_Handler::init(bool scan) { 
     isDEBUG_mode = true; 
     reScanTimer.setInterval(5000);
     connectingTimer.setInterval(100); 
-    reconnectMQTT_Timer.setInterval(2000);
+    reconnectMQTT_Timer.setInterval(MQTT_RETRY_MS);
     connect_timeout_Timer.setInterval(5000);
     mqtt_client.setClient(espclient);
     mqtt_client.setCallback(nullptr);
     isConnected = false;
     isConnecting = false;
+    scan_seq = 0;
+    scan_cnt = 0;
+    memset(&stats, 0, sizeof(stats));
+    broker.init(env.mqtt.brokers, env.mqtt.broker_cnt);
+    
+    Dev::Ft::init([this](const char* topic, const uint8_t* head, size_t head_len, const uint8_t* body, size_t body_len) {
+        publish_raw(topic, head, head_len, body, body_len);
+    });
+    
+    Dev::Ota::init([this](const char* topic, const uint8_t* head, size_t head_len, const uint8_t* body, size_t body_len) {
+        publish_raw(topic, head, head_len, body, body_len);
+    });
+    
+    Dev::Rpc::init([this](const char* topic, const String& msg) {
+        publish_raw(topic, (const uint8_t*)msg.c_str(), msg.length(), nullptr, 0);
+    });
     
     // 초기화 했으니 스캔 시작
-    WiFi.scanNetworks(true);
+    if (scan) WiFi.scanNetworks(true);
+}
+
+// 보관중인 메시지 꺼내기 ( 없으면 false )
+bool Network_Handler::pop_pending(Pending_msg& msg) {
+    if (pending_msgs.empty()) return false;
+    
+    msg = std::move(pending_msgs.front());
+    pending_msgs.pop();
+    
+    return true;
+}
+
+// 연결되면 보낼 메시지 보관 ( 큐가 찼거나 너무 길면 드랍하고 false )
+bool Network_Handler::push_pending(String topic, uint8_t format, const uint8_t* buf, size_t len) {
+    try {
+        if (MQTT_MSG_QUEUE_SIZE <= pending_msgs.size())     
+            throw "큐의 크기를 초과 합니다";
+        if (MQTT_MSG_KEEP_SIZE < len)       
+            throw "보관할 메시지가 너무 깁니다";
+        
+        Dev::Log::printf("[메시지 저장] Broker 서버 연결 시 전송합니다!\n");
+        
+        pending_msgs.push({ topic, format, std::vector<uint8_t>(buf, buf + len) });
+        
+        return true;
+    }
+    catch (const char* err) {
+        Dev::Log::printf("[메시지 드랍] 사유: %s\n", err);
+        stats.dropped++;
+        
+        return false;
+    }
+}
+
+// 스캔 없이 알고있는 AP로 바로 연결 ( 채널, BSSID를 지정해 연결 시간 단축 )
+void Network_Handler::fast_connect(String ssid, String password, int32_t channel, const uint8_t* bssid) {
+    current_info.ssid     = ssid;
+    current_info.password = password;
+    
+    Dev::Log::println("Fast connecting to " + current_info.ssid);
+    
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(current_info.ssid.c_str(), current_info.password.c_str(), channel, bssid);
+    wifi_begin_ms = millis();
+    
+    connect_timeout_Timer.reset();
+    reScanTimer.reset();
+    
+    isConnecting = true;
+}
+
+// 절전 전 MQTT, WiFi 연결 정리
+void Network_Handler::suspend() {
+    mqtt_client.disconnect();
+    reset_network_setup();
+    
+    isConnected  = false;
+    isConnecting = false;
 }
 
 // 수신받은 데이터를 객체에 업데이트 ( 이때 상태 값도 업데이트 됨 )
@@ -174,18 +344,26 @@ String Network_Handler::get_mqtt_recv() {
 
 // 스캔 결과 출력 (mqtt 서버 연결 중 일시 거기에도 출력)
 void Network_Handler::print_all_scan_results() {
-    char tmp[128]; memset(tmp, '\0', 64);
+    char tmp[128]; memset(tmp, '\0', 128);
     String scan_log;
     
-    FOR(i, 0, wifi_cnt) {
+    scan_cnt = std::min((int16_t)(sizeof(scaned_list) / sizeof(scaned_list[0])), wifi_cnt);
+    
+    FOR(i, 0, scan_cnt) {
         scaned_list[i].ssid = WiFi.SSID(i);
         scaned_list[i].RSSI = WiFi.RSSI(i);
         scaned_list[i].Encryption = (WiFi.encryptionType(i) == WIFI_AUTH_OPEN) ? "" : "[*]";
     }
     
+    // 목록을 채웠으면 출력/전송 여부와 상관없이 갱신 완료 ( RPC scan 등이 기다림 )
+    scan_seq++;
+    
+    // 스캔 결과 전송을 뺀 구성이면 AP 검색용 목록만 채움
+    if (!Dev::Scan::enabled) return;
+    
     scan_log = "";
-    FOR(i, 0, wifi_cnt) {
-        memset(tmp, '\0', 64);
+    FOR(i, 0, scan_cnt) {
+        memset(tmp, '\0', 128);
 
         // 출력할 문자열을 한 줄 씩 생성후 msg에 연결(concat)
         sprintf(
@@ -197,24 +375,42 @@ void Network_Handler::print_all_scan_results() {
         scan_log += tmp;
     }
     
+    // 압축률 측정 등에 다시 쓰기 위해 보관
+    last_scan_log = scan_log;
+    
     // 전처리한 정보 출력
-    Serial.println(scan_log);
+    Dev::Log::println(scan_log);
     
-    // MQTT 브로커 연결돼 있을 시 전송
-    if (mqtt_client.connected()) {
-        Serial.printf("Send data size: %dbyte", scan_log.length());
-        if (mqtt_client.connected()) {
-            mqtt_client.beginPublish("status", scan_log.length(), false);
-            mqtt_client.print(scan_log.c_str());
-            mqtt_client.endPublish();
+    // MSGPACK이 협상된 경우 스키마 형식으로 전송
+    if (mqtt_client.connected() && codec.getFormat("status") == FMT_MSGPACK) {
+        JsonDocument doc;
+        JsonArray arr = doc.to<JsonArray>();
+        
+        arr.add(SCHEMA_SCAN);
+        FOR(i, 0, scan_cnt) {
+            arr.add(scaned_list[i].ssid);
+            arr.add(scaned_list[i].RSSI);
+            arr.add(scaned_list[i].Encryption.length() != 0);
         }
+        
+        publish("status", doc, scan_log);
+        
+        return;
+    }
+    
+    // MQTT 브로커 연결돼 있을 시 전송 ( zip 형식이 협상됐으면 압축됨 )
+    if (mqtt_client.connected()) {
+        Dev::Log::printf("Send data size: %dbyte", scan_log.length());
+        publish("status", &scan_log);
     }
     
 }
 
 //  SPIFFS에 저장되있는 WiFi가 주변에 있는지 검색( return: ssid_list의 인덱스 )
 String Network_Handler::search_available_network() {
-    for(Wifi_info& obj : scaned_list) {      
+    FOR(i, 0, scan_cnt) {
+        Wifi_info& obj = scaned_list[i];
+        
         for(JsonPair env_wifi_iter : env.wifi_list) {
             String     env_wifi_ssid = env_wifi_iter.key().c_str();
             JsonArray  env_wifi_info = env_wifi_iter.value();
@@ -236,11 +432,9 @@ bool Network_Handler::begin_network_setup() {
     
     // 검색 결과 없으면 주기적으로 연결 재시도
     if (find_ssid == "NULL") {
-        Serial.println("!!!! 사용가능한 와이파이 없음 !!!!");
+        Dev::Log::println("!!!! 사용가능한 와이파이 없음 !!!!");
         
-        #ifdef LED_HANDLER_H 
-        led.set(2000, 50, 5);
-        #endif
+        Dev::Led::failed();
         
         // 스캔데이터 초기화
         WiFi.scanDelete();
@@ -252,18 +446,17 @@ bool Network_Handler::begin_network_setup() {
     current_info.ssid     = find_ssid;
     current_info.password = env.wifi_list[find_ssid][(int)EnvData::PASSWORD].as<String>();
 
-    Serial.println("Connecting to " + current_info.ssid);
+    Dev::Log::println("Connecting to " + current_info.ssid);
 
     WiFi.mode(WIFI_STA);
     WiFi.begin(current_info.ssid, current_info.password);
+    wifi_begin_ms = millis();
     
     connect_timeout_Timer.reset();
     
     isConnecting = true;  // 연결 중을 명시적으로 표현
     
-    #ifdef LED_HANDLER_H 
-    led.set(100, NOT_USE_BLINK);
-    #endif
+    Dev::Led::connecting();
     
     return true;
 }
@@ -273,45 +466,89 @@ void Network_Handler::reconnect() {
     String mqtt_clientId = "ESP32mqtt_client-";
     mqtt_clientId += String(random(0xffff), HEX);
 
-    if (mqtt_client.connect(mqtt_clientId.c_str(), env.mqtt.user_id, env.mqtt.user_password)) {
-        Serial.println("MQTT Broker connected!!");
+    uint32_t begin = millis();
+    bool ok = mqtt_client.connect(mqtt_clientId.c_str(), env.mqtt.user_id, env.mqtt.user_password);
+    
+    stats.mqtt_attempts++;
+    
+    if (ok) {
+        Dev::Log::println("MQTT Broker connected!!");
+        
+        // 접속 지연시간은 성공한 접속만 ( 실패는 타임아웃까지 기다린 시간이라 섞지 않음 )
+        stats.mqtt_connect_ms = millis() - begin;
+        if (stats.mqtt_connect_max_ms < stats.mqtt_connect_ms) stats.mqtt_connect_max_ms = stats.mqtt_connect_ms;
+        
+        broker.report(true);
         
         // 만약, 연결해제 상태에서 MQTT브로커 서버로 보낼 메시지가 있었을 때
-        while (!pending_msgs.empty()) {
-            auto [topic, msg] = pending_msgs.front();
+        // 보관할 때 이미 인코딩 했으므로 형식에 상관없이 그대로 전송
+        while (!pending_msgs.empty() && mqtt_client.connected()) {
+            Pending_msg& msg = pending_msgs.front();
 
-            Serial.println("묵혀온 메시지 전송! -> " + msg);
+            if (msg.format == FMT_TEXT)
+                Dev::Log::printf("묵혀온 메시지 전송! -> %.*s\n", (int)msg.body.size(), (const char*)msg.body.data());
+            else
+                Dev::Log::printf("묵혀온 메시지 전송! -> (msgpack %u byte)\n", msg.body.size());
 
-            publish(topic.c_str(), msg.c_str());
+            publish(msg.topic, msg.body.data(), msg.body.size());
             pending_msgs.pop();
+            stats.pending_flushed++;
         }
 
         // 접속이 완료되면 본인의 내부아이피 주소 전송
         char tmp[32]; memset(tmp, '\0', 32);
 
         sprintf(tmp, "wake-up! : %s", WiFi.localIP().toString().c_str());
-        publish("status", tmp);
+        
+        JsonDocument doc;
+        JsonArray arr = doc.to<JsonArray>();
+        arr.add(SCHEMA_WAKEUP);
+        arr.add((uint32_t)WiFi.localIP());
+        
+        publish("status", doc, tmp);
         
         mqtt_client.subscribe("cmd");
+        
+        Dev::Ft::subscribe(mqtt_client);
+        Dev::Ota::subscribe(mqtt_client);
+        Dev::Rpc::subscribe(mqtt_client);
     } else {
-        Serial.print("failed, rc=");
-        Serial.print(mqtt_client.state());
-        Serial.println(" try again in 2 seconds");
+        // 연속으로 실패했으면 다른 브로커로
+        if (broker.report(false)) apply_broker();
+        
+        stats.mqtt_fails++;
+        
+        Dev::Log::print("failed, rc=");
+        Dev::Log::print(mqtt_client.state());
+        Dev::Log::println(" try again in 2 seconds");
     }
 }
 
-// MQTT브로커 서버 설정
-void Network_Handler::setMQTT() {
-    // MQTT연결 설정
+// 선택된 브로커로 서버 주소 변경
+void Network_Handler::apply_broker() {
+    const MQTT_endpoint& ep = broker.current();
+    
+    env.mqtt.broker_address = ep.address;
+    env.mqtt.broker_port    = ep.port;
+    
     // env.mqtt.broker_address, env.mqtt.broker_port 이거 2개 출력
-    Serial.print("Broker Address: ");
-    Serial.println(env.mqtt.broker_address);
-    Serial.print("Port: ");
-    Serial.println(env.mqtt.broker_port);
+    Dev::Log::print("Broker Address: ");
+    Dev::Log::println(env.mqtt.broker_address);
+    Dev::Log::print("Port: ");
+    Dev::Log::println(env.mqtt.broker_port);
     
-    espclient.setInsecure();
     mqtt_client.setServer(env.mqtt.broker_address, env.mqtt.broker_port);
-    mqtt_client.setCallback(mqtt_callback);
+}
+
+// MQTT브로커 서버 설정
+void Network_Handler::setMQTT() {
+    // 접속한 네트워크에서 가장 빠른 브로커 선택 ( 후보가 1개면 측정 생략 )
+    broker.probe_all();
+    
+    Dev::Net::setup(espclient);
+    apply_broker();
+    mqtt_client.setCallback([this](char* topic, uint8_t* payload, unsigned int length) { on_message(topic, payload, length); });
+    mqtt_client.setBufferSize(MQTT_BUFFER_SIZE);
     reconnect();
 }
 
@@ -326,23 +563,14 @@ void Network_Handler::publish(String topic, String msg) {
         mqtt_client.print(name_prefix);
         mqtt_client.print(msg.c_str());
         mqtt_client.endPublish();
+        
+        stats.pub_cnt++;
+        stats.pub_bytes += msg.length()+strlen(name_prefix);
 
         return;
     } 
     
-    try {
-        if (MQTT_MSG_QUEUE_SIZE <= pending_msgs.size())     
-            throw "큐의 크기를 초과 합니다";
-        if (256 < msg.length())       
-            throw "보관할 메시지가 너무 깁니다";
-        
-        Serial.printf("[메시지 저장] Broker 서버 연결 시 전송합니다!\n");
-        
-        pending_msgs.push({topic, msg});
-    }
-    catch (const char* err) {
-        Serial.printf("[메시지 드랍] 사유: %s\n", err);
-    }
+    push_pending(topic, FMT_TEXT, (const uint8_t*)msg.c_str(), msg.length());
 }
 
 void Network_Handler::publish(String topic, String *msg) {
@@ -352,11 +580,18 @@ void Network_Handler::publish(String topic, String *msg) {
         // 현재 기기의 이름을 접두사로 해서 전송합니다
         sprintf(name_prefix, "[%s] ", env.getName().c_str());
         
+        // ZIP 형식이 협상된 토픽만 압축
+        if (Dev::Zip::enabled && codec.getFormat(topic) == FMT_ZIP && MQTT_MSG_CHUNK_SIZE < msg->length()) {
+            publish_compressed(topic, name_prefix, msg);
+            
+            return;
+        }
+        
         mqtt_client.beginPublish(topic.c_str(), msg->length()+strlen(name_prefix), false);
         mqtt_client.print(name_prefix);
         
         if (MQTT_MSG_CHUNK_SIZE < msg->length()) {
-            Serial.printf("메시지 크기 큼!!! 분할해서 송신!!! (%d)\n", msg->length());
+            Dev::Log::printf("메시지 크기 큼!!! 분할해서 송신!!! (%d)\n", msg->length());
             
             for (size_t i = 0; i < msg->length(); i += MQTT_MSG_CHUNK_SIZE) {
                 int len = std::min((size_t)MQTT_MSG_CHUNK_SIZE, msg->length() - i);
@@ -364,35 +599,174 @@ void Network_Handler::publish(String topic, String *msg) {
                 int written = mqtt_client.write((const uint8_t*)(msg->c_str() + i), len);
                 
                 if (written != len) {
-                    Serial.println("MQTT chunk write failed");
+                    Dev::Log::println("MQTT chunk write failed");
                     mqtt_client.endPublish();
                     
                     return;
                 }
             }
             
+            mqtt_client.endPublish();
+            
+            stats.pub_cnt++;
+            stats.pub_bytes += msg->length()+strlen(name_prefix);
+            
             return;
         }
         
         mqtt_client.print(msg->c_str());
         mqtt_client.endPublish();
+        
+        stats.pub_cnt++;
+        stats.pub_bytes += msg->length()+strlen(name_prefix);
 
         return;
     } 
     
-    try {
-        if (MQTT_MSG_QUEUE_SIZE <= pending_msgs.size())     
-            throw "큐의 크기를 초과 합니다";
-        if (256 < msg->length())       
-            throw "보관할 메시지가 너무 깁니다";
-        
-        Serial.printf("[메시지 저장] Broker 서버 연결 시 전송합니다!\n");
-        
-        pending_msgs.push({topic, *msg});
+    push_pending(topic, FMT_TEXT, (const uint8_t*)msg->c_str(), msg->length());
+}
+
+// 압축 헤더를 붙여 스트리밍 압축 전송 ( 길이를 먼저 알아야 하므로 2번 압축 )
+bool Network_Handler::publish_compressed(String topic, const char* name_prefix, String *msg) {
+    const uint8_t* src = (const uint8_t*)msg->c_str();
+    size_t src_len = msg->length();
+    
+    // 1회차: 압축 크기만 계산
+    uint32_t zip_len = Dev::Zip::measure(src, src_len);
+    
+    Dev::Log::printf("메시지 크기 큼!!! 압축해서 송신!!! (%d → %d)\n", src_len, zip_len);
+    
+    uint8_t header[LZ_HEADER_SIZE] = {
+        LZ_HEADER_MAGIC, 'Z', LZ_HEADER_VERSION,
+        (uint8_t)(src_len >> 24), (uint8_t)(src_len >> 16), (uint8_t)(src_len >> 8), (uint8_t)src_len
+    };
+    
+    mqtt_client.beginPublish(topic.c_str(), strlen(name_prefix)+LZ_HEADER_SIZE+zip_len, false);
+    mqtt_client.print(name_prefix);
+    mqtt_client.write(header, LZ_HEADER_SIZE);
+    
+    // 2회차: 압축 결과를 그대로 MQTT로 흘려보냄
+    bool ok = Dev::Zip::stream(src, src_len, [this](const uint8_t* buf, size_t len) {
+        return mqtt_client.write(buf, len) == len;
+    });
+    
+    if (!ok) Dev::Log::println("MQTT compressed write failed");
+    
+    mqtt_client.endPublish();
+    
+    stats.pub_cnt++;
+    stats.pub_bytes += strlen(name_prefix)+LZ_HEADER_SIZE+zip_len;
+    
+    return ok;
+}
+
+// 압축률 및 압축 비용 측정 ( 출력용 문자열 반환 )
+String Network_Handler::compress_bench(String name, String *msg) {
+    char tmp[96]; memset(tmp, '\0', 96);
+    uint32_t begin = micros();
+    
+    size_t zip_len = Dev::Zip::measure((const uint8_t*)msg->c_str(), msg->length());
+    
+    uint32_t elapsed = micros() - begin;
+    
+    sprintf(tmp, "%s: %dbyte → %dbyte (%d%%), %dus\n",
+        name.c_str(),
+        msg->length(),
+        zip_len,
+        msg->length() ? (int)(100 * zip_len / msg->length()) : 0,
+        elapsed
+    );
+    
+    return tmp;
+}
+
+// 접두사 없이 헤더+데이터를 그대로 publish ( 기기별 토픽용, 연결 해제 중일 땐 드랍 )
+bool Network_Handler::publish_raw(const char* topic, const uint8_t* head, size_t head_len, const uint8_t* body, size_t body_len) {
+    if (!mqtt_client.connected()) return false;
+    
+    mqtt_client.beginPublish(topic, head_len+body_len, false);
+    mqtt_client.write(head, head_len);
+    if (body_len) mqtt_client.write(body, body_len);
+    
+    stats.pub_cnt++;
+    stats.pub_bytes += head_len+body_len;
+    
+    return mqtt_client.endPublish();
+}
+
+// 바이너리 페이로드 publish ( 연결 해제 중일 땐 보관하지 않고 드랍 )
+void Network_Handler::publish(String topic, const uint8_t* buf, size_t len) {
+    if (!mqtt_client.connected()) {
+        Dev::Log::printf("[메시지 드랍] 사유: 바이너리 메시지는 보관하지 않습니다\n");
+        stats.dropped++;
+        return;
     }
-    catch (const char* err) {
-        Serial.printf("[메시지 드랍] 사유: %s\n", err);
+    
+    char name_prefix[32]; memset(name_prefix, '\0', 32);
+    
+    // 현재 기기의 이름을 접두사로 해서 전송합니다
+    sprintf(name_prefix, "[%s] ", env.getName().c_str());
+    
+    mqtt_client.beginPublish(topic.c_str(), len+strlen(name_prefix), false);
+    mqtt_client.print(name_prefix);
+    mqtt_client.write(buf, len);
+    mqtt_client.endPublish();
+    
+    stats.pub_cnt++;
+    stats.pub_bytes += len+strlen(name_prefix);
+}
+
+// 접속/전송 통계 ( JSON 문자열 )
+String Network_Handler::getStats() {
+    JsonDocument doc;
+    String msg;
+    
+    doc["wifi_connects"]       = stats.wifi_connects;
+    doc["wifi_connect_ms"]     = stats.wifi_connect_ms;
+    doc["mqtt_attempts"]       = stats.mqtt_attempts;
+    doc["mqtt_fails"]          = stats.mqtt_fails;
+    doc["mqtt_connect_ms"]     = stats.mqtt_connect_ms;
+    doc["mqtt_connect_max_ms"] = stats.mqtt_connect_max_ms;
+    doc["pub_cnt"]             = stats.pub_cnt;
+    doc["pub_bytes"]           = stats.pub_bytes;
+    doc["pending_flushed"]     = stats.pending_flushed;
+    doc["dropped"]             = stats.dropped;
+    doc["broker"]              = env.mqtt.broker_address;
+    doc["uptime_ms"]           = millis();
+    
+    serializeJson(doc, msg);
+    
+    return msg;
+}
+
+// 토픽에 협상된 형식으로 publish ( MSGPACK이면 doc, TEXT면 text를 전송 )
+void Network_Handler::publish(String topic, JsonDocument& doc, String text) {
+    if (codec.getFormat(topic) != FMT_MSGPACK) {
+        publish(topic, &text);
+        return;
+    }
+    
+    std::vector<uint8_t> bin;
+    size_t len = codec.encode(doc, bin, text.length());
+    
+    // 연결 해제 중에는 인코딩한 MSGPACK 그대로 보관했다가 재접속 시 전송
+    if (!mqtt_client.connected()) {
+        push_pending(topic, FMT_MSGPACK, bin.data(), len);
+        return;
     }
+    
+    publish(topic, bin.data(), len);
+}
+
+// 자유 형식 문자열 publish ( MSGPACK이면 [SCHEMA_TEXT, text] 로 )
+void Network_Handler::publish_text(String topic, String text) {
+    JsonDocument doc;
+    JsonArray arr = doc.to<JsonArray>();
+    
+    arr.add(SCHEMA_TEXT);
+    arr.add(text);
+    
+    publish(topic, doc, text);
 }
 
 void Network_Handler::reset_network_setup() {
@@ -400,8 +774,8 @@ void Network_Handler::reset_network_setup() {
     WiFi.mode(WIFI_OFF);
     
     espclient.stop();
-    espclient = WiFiClientSecure();  // 새 인스턴스 할당 ← ★ 중요!
-    espclient.setInsecure();
+    espclient = Dev::Net::Client();  // 새 인스턴스 할당 ← ★ 중요!
+    Dev::Net::setup(espclient);
     
 }
     
@@ -410,11 +784,9 @@ void Network_Handler::run() {
     
     // 예기치 않게 접속 해제 당했을 때
     if (isUnexpectedDisconnectd()) {
-        Serial.printf("[AP-OFF] %s → AP전원 꺼짐\n", current_info.ssid.c_str());
+        Dev::Log::printf("[AP-OFF] %s → AP전원 꺼짐\n", current_info.ssid.c_str());
         
-        #ifdef LED_HANDLER_H 
-        led.set(2000, 50, 5);
-        #endif
+        Dev::Led::failed();
         
          // 등록한 콜백함수 실행 ( 연결해제 됐을 때 )
         for(std::function<void()> fn_ptr : onDisconnect_cb_list) {
@@ -435,15 +807,13 @@ void Network_Handler::run() {
     if (!isConnecting && reScanTimer.isReady()) {
         // 와이파이 연결이 없고, 이미 스캔 중이 아닐 때
         if (!isScanning() && !WiFi.isConnected()) {
-            Serial.println("[Network_config] 스캔시작.");
+            Dev::Log::println("[Network_config] 스캔시작.");
 
             WiFi.scanDelete();  
             
             WiFi.scanNetworks(true);
             
-            #ifdef LED_HANDLER_H 
-            led.set(500, NOT_USE_BLINK);  // 점멸
-            #endif
+            Dev::Led::scanning();
         }
         
         reScanTimer.reset();
@@ -462,7 +832,7 @@ void Network_Handler::run() {
     // 연결 시도 중 일때
     if (isConnecting) {
         if (connectingTimer.isReady()) {
-            Serial.print(".");
+            Dev::Log::print(".");
             
             connectingTimer.reset();
         }
@@ -470,10 +840,13 @@ void Network_Handler::run() {
         if (WiFi.isConnected()) {
             randomSeed(micros());
             
-            Serial.println("");
-            Serial.println("WiFi connected");
-            Serial.println("IP address: ");
-            Serial.println(WiFi.localIP());
+            stats.wifi_connects++;
+            stats.wifi_connect_ms = millis() - wifi_begin_ms;
+            
+            Dev::Log::println("");
+            Dev::Log::println("WiFi connected");
+            Dev::Log::println("IP address: ");
+            Dev::Log::println(WiFi.localIP());
 
             // MQTT브로커 서버 연결 시작
             setMQTT();
@@ -487,16 +860,11 @@ void Network_Handler::run() {
             }
             
             if (LittleFS.begin(true)) {
-                ftpSrv.setCallback(_callback);
-                ftpSrv.setTransferCallback(_transferCallback);
-                ftpSrv.begin("admin", "1234");
-                Serial.println("LittleFS opened!");
+                Dev::Ftp::begin();
+                Dev::Log::println("LittleFS opened!");
             }
             
-            #ifdef LED_HANDLER_H 
-            // 5초에 100ms씩 2번 점멸
-            led.set(5000, 100, 2);
-            #endif
+            Dev::Led::connected();
             
             isConnected = true;
             isConnecting = false;
@@ -505,13 +873,13 @@ void Network_Handler::run() {
     
     // 연결 중인데 타임아웃 발생 시 -> 비번 틀린 거로 간주
     if (isConnecting && connect_timeout_Timer.isReady()) {
-        Serial.printf("\n%s - 연결 타임아웃.\n", current_info.ssid.c_str());
+        Dev::Log::printf("\n%s - 연결 타임아웃.\n", current_info.ssid.c_str());
 
         // 완전한 중단
         reset_network_setup();
 
         // 가장 중요한 과정으로, 현재 비밀번호가 틀린 WiFi정보를 비활성화
-        Serial.printf("[AUTH-FAIL] %s → 영구 차단\n", current_info.ssid);
+        Dev::Log::printf("[AUTH-FAIL] %s → 영구 차단\n", current_info.ssid.c_str());
         env.wifi_list[current_info.ssid][EnvData::STATUS].set(AUTH_WRONG);
         
         current_info.ssid = "";
@@ -519,9 +887,7 @@ void Network_Handler::run() {
         
         isConnecting = false;  // 타임아웃이므로 다시 false
         
-        #ifdef LED_HANDLER_H 
-        led.set(2000, 50, 5);  // 점멸
-        #endif
+        Dev::Led::failed();
         
         connect_timeout_Timer.reset();
     } 
@@ -533,57 +899,38 @@ void Network_Handler::run() {
         reconnectMQTT_Timer.reset();
     }
     
+    // 접속 중 주기적으로 다른 브로커를 측정해 충분히 빠르면 옮겨감
+    if (mqtt_client.connected() && broker.run()) {
+        mqtt_client.disconnect();
+        apply_broker();
+        reconnect();
+    }
+    
     if (isConnected) {
         mqtt_client.loop();
-        ftpSrv.handleFTP();
+        
+        Dev::Ft::run();
+        Dev::Ftp::run();
     }
+    
+    // 새 이미지는 MQTT브로커 접속까지 되어야 정상으로 판정
+    Dev::Ota::run(mqtt_client.connected());
 }
 
-/////////////////////////////////// 일반 함수 들
-
-void _callback(FtpOperation ftpOperation, unsigned int freeSpace, unsigned int totalSpace) {
-    switch (ftpOperation) {
-        case FTP_CONNECT:
-            Serial.println(F("FTP: Connected!"));
-            break;
-        case FTP_DISCONNECT:
-            Serial.println(F("FTP: Disconnected!"));
-            break;
-        case FTP_FREE_SPACE_CHANGE:
-            Serial.printf("FTP: Free space change, free %u of %u!\n", freeSpace, totalSpace);
-            break;
-        default:
-            break;
-  }
-}
-
-void _transferCallback(FtpTransferOperation ftpOperation, const char* name, unsigned int transferredSize) {
-  switch (ftpOperation) {
-    case FTP_UPLOAD_START:
-      Serial.println(F("FTP: Upload start!"));
-      break;
-    case FTP_UPLOAD:
-      Serial.printf("FTP: Upload of file %s byte %u\n", name, transferredSize);
-      break;
-    case FTP_TRANSFER_STOP:
-      Serial.println(F("FTP: Finish transfer!"));
-      break;
-    case FTP_TRANSFER_ERROR:
-      Serial.println(F("FTP: Transfer error!"));
-      break;
-    default:
-      break;
-  }
-}
-
-void mqtt_callback(char* topic, uint8_t* payload, unsigned int length) {
+// MQTT 수신 처리
+void Network_Handler::on_message(char* topic, uint8_t* payload, unsigned int length) {
+    // 파일 전송, OTA, RPC 프레임은 문자열로 바꾸지 않고 바로 처리
+    if (Dev::Ft::handle(topic, payload, length)) return;
+    if (Dev::Ota::handle(topic, payload, length)) return;
+    if (Dev::Rpc::handle(topic, payload, length)) return;
+    
     String recv;
 
     for (int i = 0; i < length; i++) recv += (char)payload[i];
     
-    Serial.printf("Message arrived [%s] > %s\n", topic, recv.c_str());
+    Dev::Log::printf("Message arrived [%s] > %s\n", topic, recv.c_str());
     
-    net.set_mqtt_recv(recv);
+    set_mqtt_recv(recv);
 }
 
 #endif
@@ -0,0 +1,517 @@
+#ifndef OTA_CORE_H
+#define OTA_CORE_H
+
+/* 개요: OTA 수신 → 검증 → 확정/롤백 흐름(상태 머신)만 담은 헤더 입니다. ( 플랫폼 독립 )
+ * --------------------------------------------
+ * 1. Arduino/ESP-IDF 에 의존하지 않으며, 플랫폼 기능은 아래 인터페이스로 주입받습니다
+ *    - OTA_flash    : 이미지를 기록할 저장소 ( ESP32: 비활성 앱 파티션, 호스트: 파티션 이미지 파일 )
+ *    - OTA_writer   : 버퍼를 저장소에 기록하는 방식 ( ESP32: 기록 태스크, 호스트: OTA_sync_writer )
+ *    - OTA_platform : 상태 파일, 시간, 재부팅, SHA-256, 로그
+ * 2. ESP32 구현은 OTA_handler.h, 호스트 구현은 test/host/OTA_host.h, 테스트는 test/test_ota 에 있습니다
+ * 3. 프레임과 이어받기/정상 판정 규칙은 OTA_handler.h 참고
+ * 4. 부팅 횟수는 setup() 맨 앞의 boot_check() 에서 셉니다
+ *    - 새 이미지가 초기화 중에 죽거나 멈춰도 재부팅마다 횟수가 올라가 OTA_BOOT_ATTEMPTS 에서 롤백됩니다
+ *    - 정상 판정 전까지는 guard() 로 멈춤을 감시합니다 ( 멈추면 재부팅 → 횟수 증가 )
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <FT_protocol.h>
+
+#define OTA_SECTOR          4096
+#define OTA_SHA_SIZE        32
+#define OTA_STATE_INTERVAL  (16 * OTA_SECTOR)  // 이어받기 위치를 저장하는 간격
+#define OTA_HEALTH_TIMEOUT  60000              // 새 이미지로 부팅 후 정상 판정까지 허용 시간 ( ms )
+#define OTA_BOOT_ATTEMPTS   3                  // 정상 판정 없이 재부팅 허용 횟수
+#define OTA_STATE_PATH      "/ota.state"
+#define OTA_BOOT_PATH       "/ota.boot"
+
+// 응답 송신 함수 ( 인자: 프레임, 길이 )
+typedef std::function<void(const uint8_t*, size_t)> OTA_reply;
+
+// 펌웨어를 기록할 저장소 ( 섹터 정렬된 위치에 섹터 이하 크기로 기록 )
+class OTA_flash {
+    public:
+        virtual ~OTA_flash() = default;
+
+        // 기록 가능한 최대 크기
+        virtual size_t capacity() = 0;
+
+        // 기록 ( 해당 섹터 지우기 포함 )
+        virtual bool write(uint32_t offset, const uint8_t* buf, size_t len) = 0;
+
+        // 읽기 ( 검증용 )
+        virtual bool read(uint32_t offset, uint8_t* buf, size_t len) = 0;
+
+        // 다음 부팅을 새 이미지로
+        virtual bool activate() = 0;
+
+        // 현재 이미지를 정상으로 확정
+        virtual bool confirm() = 0;
+
+        // 이전 이미지로 부팅하도록 되돌림
+        virtual bool rollback() = 0;
+
+        // 부트로더가 현재 이미지의 정상 판정을 기다리는 중인지 ( 지원하지 않으면 false )
+        virtual bool pending() { return false; }
+};
+
+// 섹터 버퍼 2개를 저장소에 기록 ( 하나를 채우는 동안 다른 하나를 기록할 수 있음 )
+class OTA_writer {
+    protected:
+        OTA_flash* flash;
+        uint8_t    bufs[2][OTA_SECTOR];
+
+    public:
+        explicit OTA_writer(OTA_flash* flash) : flash(flash) {}
+        virtual ~OTA_writer() = default;
+
+        uint8_t* buffer(uint8_t idx) { return bufs[idx]; }
+
+        // offset 부터 다시 기록할 준비 ( 진행 중인 기록은 drain() 으로 먼저 끝내야 함 )
+        virtual void reset(uint32_t offset) = 0;
+
+        // 빈 버퍼 번호 ( 없으면 생길 때까지 대기 )
+        virtual uint8_t acquire() = 0;
+
+        // 채운 버퍼 기록 요청 ( 기록이 끝나면 다시 빈 버퍼가 됨 )
+        virtual void submit(uint8_t idx, uint32_t offset, uint32_t len) = 0;
+
+        // 채우지 않은 버퍼 반환
+        virtual void release(uint8_t idx) = 0;
+
+        // 요청한 기록이 모두 끝날 때까지 대기 ( 실패가 있었으면 false )
+        virtual bool drain() = 0;
+
+        // 기록 실패 여부
+        virtual bool failed() = 0;
+
+        // 저장소에 기록 완료된 위치
+        virtual uint32_t durable() = 0;
+};
+
+// 요청 즉시 기록 ( 태스크가 없는 환경용 )
+class OTA_sync_writer : public OTA_writer {
+    private:
+        uint8_t  turn;
+        uint32_t done;
+        bool     err;
+
+    public:
+        explicit OTA_sync_writer(OTA_flash* flash) : OTA_writer(flash), turn(0), done(0), err(false) {}
+
+        void reset(uint32_t offset) override { done = offset; err = false; }
+
+        uint8_t acquire() override { return turn ^= 1; }
+
+        void submit(uint8_t idx, uint32_t offset, uint32_t len) override {
+            if (flash->write(offset, bufs[idx], len)) done = offset + len;
+            else err = true;
+        }
+
+        void release(uint8_t) override {}
+        bool drain() override { return !err; }
+        bool failed() override { return err; }
+        uint32_t durable() override { return done; }
+};
+
+// 상태 파일, 시간, 재부팅, 해시, 로그
+class OTA_platform {
+    public:
+        virtual ~OTA_platform() = default;
+
+        // 부팅 후 경과 시간 ( ms )
+        virtual uint32_t now_ms() = 0;
+
+        // 재부팅 ( 호스트에서는 기록만 하고 돌아옴 )
+        virtual void restart() = 0;
+
+        // 작은 상태 파일 읽기/쓰기 ( len 만큼 읽지 못하면 false )
+        virtual bool load(const char* path, uint8_t* buf, size_t len) = 0;
+        virtual bool store(const char* path, const uint8_t* buf, size_t len) = 0;
+        virtual bool exists(const char* path) = 0;
+        virtual void remove(const char* path) = 0;
+
+        // SHA-256
+        virtual void sha_begin() = 0;
+        virtual void sha_update(const uint8_t* buf, size_t len) = 0;
+        virtual void sha_finish(uint8_t* digest) = 0;
+
+        // 로그 한 줄
+        virtual void log(const char* msg) = 0;
+
+        // 멈춤 감시 ( true: 일정 시간 응답이 없으면 재부팅, false: 해제 )
+        virtual void guard(bool on) = 0;
+};
+
+class OTA_core {
+    private:
+        OTA_flash*    flash;
+        OTA_writer*   writer;
+        OTA_platform* platform;
+        OTA_reply     sender;
+
+        enum { IDLE, RECEIVING } state;
+        uint8_t  id;
+        uint8_t  sha[OTA_SHA_SIZE];
+        uint32_t total;
+        uint32_t next;              // 다음에 받을 위치
+        uint32_t saved;             // 저장된 이어받기 위치
+        int      cur;               // 채우는 중인 버퍼 ( 없으면 -1 )
+        uint32_t fill;
+
+        // 부팅 후 정상 판정 관련
+        bool     isPendingVerify;
+        uint32_t reboot_at;         // 0이 아니면 해당 시각에 재부팅
+
+        void logf(const char* fmt, ...);
+        void reply(uint8_t status, uint32_t offset);
+        void submit();
+        bool drain(bool flush_partial);
+        void reset_buffers(uint32_t offset);
+        bool load_state();
+        void save_state();
+        bool verify();
+        void rollback(const char* reason);
+
+        void on_open(FT_frame& frame);
+        void on_data(FT_frame& frame);
+        void on_commit(FT_frame& frame);
+
+    public:
+        OTA_core(OTA_flash* flash, OTA_writer* writer, OTA_platform* platform)
+            : flash(flash), writer(writer), platform(platform), state(IDLE), cur(-1), fill(0),
+              isPendingVerify(false), reboot_at(0) {}
+
+        // 부팅 직후 호출 ( 새 이미지면 부팅 횟수 증가, 초과 시 롤백 )
+        void boot_check();
+
+        // 초기화 ( 응답을 내보낼 함수 등록 )
+        void init(OTA_reply sender);
+
+        // 새 이미지 정상 판정 대기 중인지
+        bool pending() { return isPendingVerify; }
+
+        // 수신 프레임 처리
+        void handle(const uint8_t* payload, size_t length);
+
+        // non-blocking 실행 ( healthy: 정상 동작 여부, 새 이미지 확정/롤백 판단에 사용 )
+        void run(bool healthy);
+};
+
+void OTA_core::logf(const char* fmt, ...) {
+    char tmp[96];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(tmp, sizeof(tmp), fmt, args);
+    va_end(args);
+
+    platform->log(tmp);
+}
+
+// 부팅 직후 호출 ( 새 이미지면 부팅 횟수 증가, 초과 시 롤백 )
+// 다른 모듈 초기화보다 먼저 불러야 초기화 중 죽거나 멈추는 이미지도 횟수에 잡힘
+void OTA_core::boot_check() {
+    bool marked = platform->exists(OTA_BOOT_PATH);
+
+    // 업데이트 직후의 부팅이면 정상 판정 대기, 너무 여러번 재부팅 됐으면 바로 롤백
+    isPendingVerify = marked || flash->pending();
+
+    if (!isPendingVerify) return;
+
+    // 부팅 파일이 없으면 ( 부트로더만 대기 중 ) 처음부터 셈
+    uint8_t attempts = 0;
+
+    if (marked) platform->load(OTA_BOOT_PATH, &attempts, 1);
+    attempts++;
+
+    logf("[OTA] 새 이미지 확인 중 (%u/%u)", attempts, OTA_BOOT_ATTEMPTS);
+
+    if (OTA_BOOT_ATTEMPTS <= attempts) {
+        rollback("정상 판정 실패");
+        return;
+    }
+
+    platform->store(OTA_BOOT_PATH, &attempts, 1);
+    platform->guard(true);
+}
+
+// 초기화 ( 응답을 내보낼 함수 등록 )
+void OTA_core::init(OTA_reply sender) {
+    this->sender = sender;
+    state     = IDLE;
+    cur       = -1;
+    fill      = 0;
+    reboot_at = 0;
+}
+
+void OTA_core::reply(uint8_t status, uint32_t offset) {
+    uint8_t header[FT_HEADER_SIZE];
+
+    ft_header(header, FT_OP_ACK, id, status, offset, 0);
+    sender(header, FT_HEADER_SIZE);
+}
+
+// 채우던 버퍼를 기록 요청
+void OTA_core::submit() {
+    if (cur < 0) return;
+
+    // 채운 게 없으면 그냥 빈 버퍼로 되돌림
+    if (fill == 0) writer->release(cur);
+    else           writer->submit(cur, next - fill, fill);
+
+    cur  = -1;
+    fill = 0;
+}
+
+// 요청한 버퍼가 모두 기록될 때까지 대기 ( 실패 시 false )
+// flush_partial이 false면 채우던 버퍼는 버림 ( 이어받기 위치를 섹터 단위로 유지하기 위해 )
+bool OTA_core::drain(bool flush_partial) {
+    if (!flush_partial) {
+        next -= fill;
+        fill  = 0;
+    }
+
+    submit();
+
+    return writer->drain();
+}
+
+// 버퍼를 비우고 offset 부터 다시 받을 준비 ( offset은 섹터 정렬 )
+void OTA_core::reset_buffers(uint32_t offset) {
+    drain(false);
+    writer->reset(offset);
+
+    cur   = -1;
+    fill  = 0;
+    next  = offset;
+    saved = offset;
+}
+
+// 저장된 이어받기 정보가 지금 이미지와 같으면 그 위치를 next로 ( 다르면 false )
+bool OTA_core::load_state() {
+    uint8_t buf[OTA_SHA_SIZE + 8];
+    uint32_t saved_total, saved_offset;
+
+    if (!platform->load(OTA_STATE_PATH, buf, sizeof(buf))) return false;
+
+    memcpy(&saved_total,  buf + OTA_SHA_SIZE,     4);
+    memcpy(&saved_offset, buf + OTA_SHA_SIZE + 4, 4);
+
+    if (saved_total != total || memcmp(buf, sha, OTA_SHA_SIZE) != 0) return false;
+
+    reset_buffers(saved_offset);
+
+    return true;
+}
+
+void OTA_core::save_state() {
+    uint8_t buf[OTA_SHA_SIZE + 8];
+    uint32_t offset = writer->durable();
+
+    memcpy(buf, sha, OTA_SHA_SIZE);
+    memcpy(buf + OTA_SHA_SIZE,     &total,  4);
+    memcpy(buf + OTA_SHA_SIZE + 4, &offset, 4);
+
+    if (platform->store(OTA_STATE_PATH, buf, sizeof(buf))) saved = offset;
+}
+
+// 기록된 이미지를 다시 읽어 SHA-256 검증 ( 기록이 모두 끝난 뒤라 버퍼 0번을 읽기용으로 사용 )
+bool OTA_core::verify() {
+    uint8_t digest[OTA_SHA_SIZE];
+    uint8_t* buf = writer->buffer(0);
+    bool ok = true;
+
+    platform->sha_begin();
+
+    for (uint32_t offset = 0; ok && offset < total; offset += OTA_SECTOR) {
+        size_t len = std::min((uint32_t)OTA_SECTOR, total - offset);
+
+        ok = flash->read(offset, buf, len);
+        if (ok) platform->sha_update(buf, len);
+    }
+
+    platform->sha_finish(digest);
+
+    return ok && memcmp(digest, sha, OTA_SHA_SIZE) == 0;
+}
+
+void OTA_core::rollback(const char* reason) {
+    logf("[OTA] %s → 이전 이미지로 롤백", reason);
+
+    platform->remove(OTA_BOOT_PATH);
+    isPendingVerify = false;
+
+    flash->rollback();
+    platform->restart();
+}
+
+// 수신 프레임 처리
+void OTA_core::handle(const uint8_t* payload, size_t length) {
+    FT_frame frame;
+
+    if (!ft_parse(payload, length, frame)) {
+        platform->log("[OTA] 잘못된 프레임");
+        return;
+    }
+
+    if (frame.op == FT_OP_PUT) {
+        on_open(frame);
+        return;
+    }
+
+    if (state != RECEIVING || frame.id != id) {
+        if (frame.op != FT_OP_ACK) reply(FT_ERR_STATE, 0);
+        return;
+    }
+
+    switch (frame.op) {
+        case FT_OP_DATA:   on_data(frame);   break;
+        case FT_OP_COMMIT: on_commit(frame); break;
+        case FT_OP_ABORT:
+            platform->log("[OTA] 취소");
+            drain(false);
+            save_state();
+            state = IDLE;
+            break;
+        default:
+            break;
+    }
+}
+
+void OTA_core::on_open(FT_frame& frame) {
+    if (frame.len != OTA_SHA_SIZE || flash->capacity() < frame.offset) {
+        id = frame.id;
+        reply(FT_ERR_SIZE, 0);
+        return;
+    }
+
+    bool same = state == RECEIVING && frame.offset == total && memcmp(frame.data, sha, OTA_SHA_SIZE) == 0;
+
+    id    = frame.id;
+    total = frame.offset;
+    memcpy(sha, frame.data, OTA_SHA_SIZE);
+
+    // 같은 이미지면 메모리 → 상태 파일 순으로 이어받을 위치를 찾고, 없으면 처음부터
+    if (!same && !load_state()) reset_buffers(0);
+
+    logf("[OTA] OPEN (%u/%ubyte)", (unsigned)next, (unsigned)total);
+
+    state = RECEIVING;
+    reply(FT_OK, next);
+}
+
+void OTA_core::on_data(FT_frame& frame) {
+    if (frame.offset != next) {
+        reply(FT_ERR_OFFSET, next);
+        return;
+    }
+
+    if (ft_crc32(frame.data, frame.len) != frame.crc) {
+        reply(FT_ERR_CRC, next);
+        return;
+    }
+
+    if (total < next + frame.len || writer->failed()) {
+        reply(writer->failed() ? FT_ERR_IO : FT_ERR_SIZE, next);
+        return;
+    }
+
+    const uint8_t* data = frame.data;
+    size_t len = frame.len;
+
+    while (len) {
+        // 빈 버퍼가 없으면 기록이 끝나 하나 비워질 때까지 대기
+        if (cur < 0) {
+            cur  = writer->acquire();
+            fill = 0;
+        }
+
+        size_t n = std::min(len, (size_t)(OTA_SECTOR - fill));
+
+        memcpy(writer->buffer(cur) + fill, data, n);
+        fill += n;
+        next += n;
+        data += n;
+        len  -= n;
+
+        if (fill == OTA_SECTOR) submit();
+    }
+
+    reply(FT_OK, next);
+}
+
+void OTA_core::on_commit(FT_frame&) {
+    if (next != total) {
+        reply(FT_ERR_SIZE, next);
+        return;
+    }
+
+    if (!drain(true)) {
+        reply(FT_ERR_IO, next);
+        return;
+    }
+
+    // 검증에 실패한 이미지는 이어받아도 소용 없으므로 처음부터
+    if (!verify()) {
+        platform->log("[OTA] SHA-256 불일치");
+        platform->remove(OTA_STATE_PATH);
+        state = IDLE;
+        reply(FT_ERR_CRC, 0);
+        return;
+    }
+
+    if (!flash->activate()) {
+        platform->log("[OTA] 부팅 파티션 변경 실패");
+        state = IDLE;
+        reply(FT_ERR_IO, next);
+        return;
+    }
+
+    uint8_t attempts = 0;
+
+    platform->remove(OTA_STATE_PATH);
+    platform->store(OTA_BOOT_PATH, &attempts, 1);
+
+    platform->log("[OTA] 완료, 재부팅 합니다");
+
+    state = IDLE;
+    reply(FT_OK, next);
+
+    // 응답이 전송될 시간을 주고 재부팅
+    reboot_at = (platform->now_ms() + 1000) | 1;
+}
+
+// non-blocking 실행 ( healthy: 정상 동작 여부, 새 이미지 확정/롤백 판단에 사용 )
+void OTA_core::run(bool healthy) {
+    uint32_t now = platform->now_ms();
+
+    if (reboot_at && (int32_t)(now - reboot_at) >= 0) {
+        reboot_at = 0;
+        platform->restart();
+    }
+
+    // 수신 중에는 주기적으로 이어받기 위치 저장
+    if (state == RECEIVING && OTA_STATE_INTERVAL <= writer->durable() - saved) save_state();
+
+    if (!isPendingVerify) return;
+
+    if (healthy) {
+        platform->log("[OTA] 새 이미지 정상 확정");
+        flash->confirm();
+        platform->remove(OTA_BOOT_PATH);
+        platform->guard(false);
+        isPendingVerify = false;
+        return;
+    }
+
+    if (OTA_HEALTH_TIMEOUT < now) rollback("정상 판정 시간 초과");
+}
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef OTA_HANDLER_H
+#define OTA_HANDLER_H
+
+/* 개요: MQTT로 펌웨어를 받아 업데이트(OTA)하는 헤더 입니다.
+ * --------------------------------------------
+ * 1. "ota/<기기이름>/in" 으로 이미지를 받고 "ota/<기기이름>/out" 으로 응답합니다 ( 프레임은 File_transfer.h 와 동일 )
+ * 2. 받은 청크는 4KB 버퍼 2개를 번갈아 채우고, 찬 버퍼는 별도 태스크가 비활성 파티션에 바로 기록합니다
+ * 3. COMMIT 시 파티션을 다시 읽어 SHA-256을 검증한 후 부팅 파티션을 바꾸고 재부팅 합니다
+ * 4. 새 이미지로 부팅 후 OTA_HEALTH_TIMEOUT 안에 MQTT브로커에 접속하지 못하면 이전 이미지로 되돌립니다
+ *    - setup() 맨 앞에서 Dev::Ota::boot_check() 를 불러야 초기화 중 죽는 이미지도 롤백됩니다
+ *    - 정상 판정 전까지 Arduino가 이미지를 자동 확정하지 않게 하고( verifyRollbackLater ),
+ *      loop 태스크를 OTA_WDT_TIMEOUT 동안 멈추면 재부팅 되게 감시합니다
+ * 5. 끊긴 뒤 같은 이미지(SHA-256)로 다시 OPEN 하면 기록된 위치부터 이어받습니다 ( 재부팅 후에도 가능 )
+ * 6. 흐름(상태 머신)은 플랫폼 독립인 OTA_core.h 에 있고, 이 헤더는 ESP32 구현만 담습니다
+ *    - OTA_partition    : 비활성 앱 파티션 ( OTA_flash )
+ *    - OTA_task_writer  : 찬 버퍼를 별도 태스크에서 기록 ( OTA_writer )
+ *    - OTA_esp_platform : LittleFS 상태 파일, millis, ESP.restart, mbedtls SHA-256, 로그 ( OTA_platform )
+ *    - 호스트에서는 파티션 이미지 파일로 같은 흐름을 검증합니다 ( test/test_ota )
+ *
+ * 프레임 사용법 ( File_transfer.h 의 FT_op 재사용 )
+ * --------------------------------------------
+ * - PUT    offset: 이미지 크기, data: SHA-256 32byte   → ACK offset: 이어받을 위치
+ * - DATA   offset: 청크 위치, crc: 청크 CRC, data: 청크
+ * - COMMIT                                           → ACK status: 결과 ( 성공 시 잠시 후 재부팅 )
+ * - ABORT  취소 ( 기록된 위치는 이어받기를 위해 남겨둠 )
+*/
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <env.h>
+#include <Log_config.h>
+#include <File_transfer.h>
+#include <OTA_core.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <mbedtls/sha256.h>
+#include <esp_task_wdt.h>
+
+#define OTA_WDT_TIMEOUT 30  // 정상 판정 전 멈춤 감시 시간 ( s )
+
+// Arduino가 setup() 전에 새 이미지를 자동 확정하지 않도록 ( 확정은 OTA_core::run 에서 )
+extern "C" bool verifyRollbackLater() { return true; }
+
+// ESP32 비활성 앱 파티션
+class OTA_partition : public OTA_flash {
+    private:
+        const esp_partition_t* target() { return esp_ota_get_next_update_partition(NULL); }
+
+    public:
+        size_t capacity() override {
+            return target() ? target()->size : 0;
+        }
+
+        bool write(uint32_t offset, const uint8_t* buf, size_t len) override {
+            const esp_partition_t* part = target();
+            size_t erase_len = (len + OTA_SECTOR - 1) / OTA_SECTOR * OTA_SECTOR;
+
+            if (!part || part->size < offset + len) return false;
+            if (esp_partition_erase_range(part, offset, erase_len) != ESP_OK) return false;
+
+            return esp_partition_write(part, offset, buf, len) == ESP_OK;
+        }
+
+        bool read(uint32_t offset, uint8_t* buf, size_t len) override {
+            const esp_partition_t* part = target();
+
+            return part && esp_partition_read(part, offset, buf, len) == ESP_OK;
+        }
+
+        // 이미지 헤더 검증도 여기서 같이 수행됨
+        bool activate() override {
+            return target() && esp_ota_set_boot_partition(target()) == ESP_OK;
+        }
+
+        bool confirm() override {
+            esp_ota_mark_app_valid_cancel_rollback();
+
+            return true;
+        }
+
+        // 부트로더가 대기 중이면 무효 처리 후 바로 재부팅 ( 돌아오지 않음 )
+        // 아니면 새 이미지로 부팅한 상태이므로 이전 이미지가 다음 업데이트 대상 파티션
+        bool rollback() override {
+            if (pending()) esp_ota_mark_app_invalid_rollback_and_reboot();
+
+            return target() && esp_ota_set_boot_partition(target()) == ESP_OK;
+        }
+
+        bool pending() override {
+            esp_ota_img_states_t state;
+
+            return esp_ota_get_state_partition(esp_ota_get_running_partition(), &state) == ESP_OK
+                && state == ESP_OTA_IMG_PENDING_VERIFY;
+        }
+};
+
+// 기록 태스크로 넘기는 버퍼 정보
+typedef struct OTA_block {
+    uint8_t  idx;
+    uint32_t offset;
+    uint32_t len;
+} OTA_block;
+
+// 찬 버퍼를 별도 태스크에서 기록 ( 기록하는 동안 loop()는 다음 버퍼를 채움 )
+class OTA_task_writer : public OTA_writer {
+    private:
+        QueueHandle_t free_q;       // 비어있는 버퍼 번호
+        QueueHandle_t full_q;       // 기록할 버퍼 ( OTA_block )
+        TaskHandle_t  task;
+        volatile uint32_t done;     // 기록 완료된 위치
+        volatile bool     err;
+
+        static void writer_task(void* arg);
+
+    public:
+        explicit OTA_task_writer(OTA_flash* flash) : OTA_writer(flash), task(nullptr), done(0), err(false) {}
+
+        void reset(uint32_t offset) override;
+
+        uint8_t acquire() override {
+            uint8_t idx;
+
+            xQueueReceive(free_q, &idx, portMAX_DELAY);
+
+            return idx;
+        }
+
+        void submit(uint8_t idx, uint32_t offset, uint32_t len) override {
+            OTA_block block = { idx, offset, len };
+
+            xQueueSend(full_q, &block, portMAX_DELAY);
+        }
+
+        void release(uint8_t idx) override { xQueueSend(free_q, &idx, portMAX_DELAY); }
+
+        bool drain() override;
+        bool failed() override { return err; }
+        uint32_t durable() override { return done; }
+};
+
+// 기록 태스크: 찬 버퍼를 받아 플래시에 쓰고 다시 빈 버퍼로 돌려줌
+void OTA_task_writer::writer_task(void* arg) {
+    OTA_task_writer* self = (OTA_task_writer*)arg;
+    OTA_block block;
+
+    for (;;) {
+        xQueueReceive(self->full_q, &block, portMAX_DELAY);
+
+        if (self->flash->write(block.offset, self->bufs[block.idx], block.len))
+            self->done = block.offset + block.len;
+        else
+            self->err = true;
+
+        xQueueSend(self->free_q, &block.idx, portMAX_DELAY);
+    }
+}
+
+// 처음 쓸 때 큐와 태스크 생성
+void OTA_task_writer::reset(uint32_t offset) {
+    if (!task) {
+        free_q = xQueueCreate(2, sizeof(uint8_t));
+        full_q = xQueueCreate(2, sizeof(OTA_block));
+        xTaskCreate(writer_task, "ota_writer", 4096, this, 1, &task);
+    }
+
+    xQueueReset(free_q);
+    xQueueReset(full_q);
+    for (uint8_t i = 0; i < 2; i++) xQueueSend(free_q, &i, 0);
+
+    done = offset;
+    err  = false;
+}
+
+// 두 버퍼가 모두 빈 버퍼로 돌아올 때까지 대기
+bool OTA_task_writer::drain() {
+    if (task) while (uxQueueMessagesWaiting(free_q) < 2) vTaskDelay(1);
+
+    return !err;
+}
+
+// LittleFS, millis, ESP.restart, mbedtls
+class OTA_esp_platform : public OTA_platform {
+    private:
+        mbedtls_sha256_context ctx;
+
+    public:
+        uint32_t now_ms() override { return millis(); }
+        void restart() override { ESP.restart(); }
+
+        bool load(const char* path, uint8_t* buf, size_t len) override {
+            File file = LittleFS.open(path, FILE_READ);
+
+            if (!file) return false;
+
+            bool ok = file.read(buf, len) == len;
+            file.close();
+
+            return ok;
+        }
+
+        bool store(const char* path, const uint8_t* buf, size_t len) override {
+            File file = LittleFS.open(path, FILE_WRITE);
+
+            if (!file) return false;
+
+            bool ok = file.write(buf, len) == len;
+            file.close();
+
+            return ok;
+        }
+
+        bool exists(const char* path) override { return LittleFS.exists(path); }
+        void remove(const char* path) override { LittleFS.remove(path); }
+
+        void sha_begin() override {
+            mbedtls_sha256_init(&ctx);
+            mbedtls_sha256_starts(&ctx, 0);
+        }
+
+        void sha_update(const uint8_t* buf, size_t len) override { mbedtls_sha256_update(&ctx, buf, len); }
+
+        void sha_finish(uint8_t* digest) override {
+            mbedtls_sha256_finish(&ctx, digest);
+            mbedtls_sha256_free(&ctx);
+        }
+
+        void log(const char* msg) override { Dev_log::println(msg); }
+
+        // loop 태스크가 OTA_WDT_TIMEOUT 동안 돌지 않으면 패닉 → 재부팅
+        void guard(bool on) override {
+            if (on) {
+                esp_task_wdt_init(OTA_WDT_TIMEOUT, true);
+                enableLoopWDT();
+            } else {
+                disableLoopWDT();
+            }
+        }
+};
+
+class OTA_handler {
+    private:
+        OTA_partition    partition;
+        OTA_task_writer  writer;
+        OTA_esp_platform platform;
+        OTA_core         core;
+
+        String in_topic;
+        String out_topic;
+        FT_sender sender;
+
+    public:
+        OTA_handler() : writer(&partition), core(&partition, &writer, &platform) {}
+        OTA_handler& operator=(const OTA_handler& ref) = delete;
+        static OTA_handler& GetInstance();
+
+        // 부팅 직후 호출 ( LittleFS 마운트 후 새 이미지 부팅 횟수 확인 )
+        void boot_check();
+
+        // 초기화 ( 응답을 내보낼 함수 등록 )
+        void init(FT_sender sender);
+
+        // 구독할 토픽
+        String getTopic() { return in_topic; }
+
+        // 새 이미지 정상 판정 대기 중인지
+        bool pending() { return core.pending(); }
+
+        // 수신 메시지 처리 ( OTA 토픽이 아니면 false )
+        bool handle(const char* topic, const uint8_t* payload, unsigned int length);
+
+        // non-blocking 실행 ( healthy: 정상 동작 여부, 새 이미지 확정/롤백 판단에 사용 )
+        void run(bool healthy) { core.run(healthy); }
+};
+
+OTA_handler& OTA_handler::GetInstance() {
+    static OTA_handler instance;
+
+    return instance;
+}
+
+// 부팅 직후 호출 ( LittleFS 마운트 후 새 이미지 부팅 횟수 확인 )
+void OTA_handler::boot_check() {
+    if (!LittleFS.begin(true)) Dev_log::println("[OTA] LittleFS 마운트 실패");
+
+    core.boot_check();
+}
+
+// 초기화 ( 응답을 내보낼 함수 등록 )
+void OTA_handler::init(FT_sender sender) {
+    this->sender = sender;
+    in_topic  = "ota/" + env.getName() + "/in";
+    out_topic = "ota/" + env.getName() + "/out";
+
+    core.init([this](const uint8_t* buf, size_t len) {
+        this->sender(out_topic.c_str(), buf, len, nullptr, 0);
+    });
+}
+
+// 수신 메시지 처리 ( OTA 토픽이 아니면 false )
+bool OTA_handler::handle(const char* topic, const uint8_t* payload, unsigned int length) {
+    if (in_topic != topic) return false;
+
+    core.handle(payload, length);
+
+    return true;
+}
+
+// Device_config.h 의 OTA 정책
+struct OTA_on {
+    static constexpr size_t frame_size = FT_HEADER_SIZE + FT_CHUNK_SIZE;
+
+    // setup() 맨 앞에서 호출
+    static void boot_check() { OTA_handler::GetInstance().boot_check(); }
+
+    // 새 이미지 정상 판정 대기 중인지 ( 대기 중엔 절전하지 않음 )
+    static bool pending() { return OTA_handler::GetInstance().pending(); }
+
+    static void init(FT_sender sender) { OTA_handler::GetInstance().init(sender); }
+
+    template <typename C>
+    static void subscribe(C& client) { client.subscribe(OTA_handler::GetInstance().getTopic().c_str()); }
+
+    static bool handle(const char* topic, const uint8_t* payload, unsigned int length) {
+        return OTA_handler::GetInstance().handle(topic, payload, length);
+    }
+
+    // 새 이미지는 MQTT브로커 접속까지 되어야 정상으로 판정
+    static void run(bool healthy) { OTA_handler::GetInstance().run(healthy); }
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+/* 개요: MQTT로 송신하는 메시지의 인코딩 형식을 관리하는 헤더 입니다.
+ * --------------------------------------------
+ * 1. 토픽 별로 TEXT / MSGPACK / ZIP 형식을 협상합니다 ( 기본값: TEXT )
+ *    - ZIP: TEXT와 같지만 MQTT_MSG_CHUNK_SIZE 보다 크면 압축해서 전송 ( Stream_compressor.h, 압축이 빠진 구성에서는 거부 )
+ * 2. MSGPACK은 키 없이 [스키마ID, 필드...] 배열로 직렬화 합니다 ( 스키마 기반 )
+ * 3. 인코딩 비용(us)과 TEXT 대비 크기를 누적 측정합니다
+ *
+ * 4. MQTT 연결 해제 중에도 협상된 형식 그대로 보관했다가 재접속 시 전송합니다 ( Network_config.h 의 Pending_msg )
+ * 5. 부팅 시 setup()에서 한번만 초기화하며, 절전 복귀 시엔 RTC에 저장한 형식을 다시 적용합니다 ( Sleep_handler.h )
+ *
+ * 수신측 디코딩 방법
+ * --------------------------------------------
+ * 1. 페이로드 앞의 "[기기이름] " 접두사를 제거합니다
+ * 2. 나머지를 MessagePack 배열로 디코딩 후, 첫번째 원소(스키마ID)로 Payload_decoder.h 의 표를 참고해 필드를 해석합니다
+ *    - ip는 IPAddress를 uint32로 변환한 값 ( 리틀엔디안, 첫 옥텟이 최하위 바이트 )
+ * 3. 서버에서는 Payload_decoder.h 의 payload_decode() 로 위 과정을 한번에 JSON으로 바꿀 수 있습니다
+*/
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Log_config.h>
+#include <Payload_decoder.h>
+#include <map>
+#include <vector>
+
+enum Payload_format {
+    FMT_TEXT    = 0,
+    FMT_MSGPACK = 1,
+    FMT_ZIP     = 2
+};
+
+class Payload_codec {
+    private:
+        std::map<String, Payload_format> topic_fmt;
+        bool zip_enabled;   // ZIP 형식 허용 여부 ( 압축 모듈 포함 여부 )
+
+        // 인코딩 비용 측정값
+        uint32_t enc_cnt;
+        uint32_t enc_us;
+        uint32_t bin_bytes;
+        uint32_t text_bytes;
+
+    public:
+        Payload_codec() = default;
+        Payload_codec& operator=(const Payload_codec& ref) = delete;
+        static Payload_codec& GetInstance();
+
+        // 초기화 ( zip: ZIP 형식 허용 여부 )
+        void init(bool zip);
+
+        // 토픽 별 인코딩 형식 설정
+        void setFormat(String topic, Payload_format fmt);
+
+        // 토픽 별 인코딩 형식 조회 ( 협상된 적 없으면 TEXT )
+        Payload_format getFormat(String topic);
+
+        // 협상된 토픽마다 fn(토픽, 형식) 호출 ( 절전 전 RTC 저장용, Sleep_handler.h )
+        template <typename F>
+        void for_each(F fn) { for (auto& iter : topic_fmt) fn(iter.first, iter.second); }
+
+        // 형식 이름 ( text, msgpack, zip )
+        static const char* formatName(Payload_format fmt);
+
+        // "fmt <topic> <text|msgpack|zip>" 명령 처리 ( 처리했으면 true )
+        bool negotiate(String cmd);
+
+        // doc를 MSGPACK으로 직렬화 ( text_len: 같은 내용을 TEXT로 보냈을 때의 크기, 비교용 )
+        size_t encode(JsonDocument& doc, std::vector<uint8_t>& out, size_t text_len);
+
+        // 누적 측정값 출력용 문자열
+        String stats();
+};
+
+Payload_codec& Payload_codec::GetInstance() {
+    static Payload_codec instance;
+
+    return instance;
+}
+
+// 초기화 ( zip: ZIP 형식 허용 여부 )
+void Payload_codec::init(bool zip) {
+    topic_fmt.clear();
+    zip_enabled = zip;
+    enc_cnt    = 0;
+    enc_us     = 0;
+    bin_bytes  = 0;
+    text_bytes = 0;
+}
+
+// 토픽 별 인코딩 형식 설정
+void Payload_codec::setFormat(String topic, Payload_format fmt) {
+    topic_fmt[topic] = fmt;
+}
+
+// 토픽 별 인코딩 형식 조회 ( 협상된 적 없으면 TEXT )
+Payload_format Payload_codec::getFormat(String topic) {
+    auto iter = topic_fmt.find(topic);
+
+    if (iter == topic_fmt.end()) return FMT_TEXT;
+
+    return iter->second;
+}
+
+// 형식 이름 ( text, msgpack, zip )
+const char* Payload_codec::formatName(Payload_format fmt) {
+    switch (fmt) {
+        case FMT_MSGPACK: return "msgpack";
+        case FMT_ZIP:     return "zip";
+        default:          return "text";
+    }
+}
+
+// "fmt <topic> <text|msgpack|zip>" 명령 처리 ( 처리했으면 true )
+bool Payload_codec::negotiate(String cmd) {
+    if (!cmd.startsWith("fmt ")) return false;
+
+    int sep = cmd.indexOf(' ', 4);
+
+    if (sep < 0) {
+        Dev_log::println("[codec] 사용법: fmt <topic> <text|msgpack|zip>");
+        return true;
+    }
+
+    String topic = cmd.substring(4, sep);
+    String fmt   = cmd.substring(sep + 1);
+
+    if (fmt == "msgpack" || fmt == "mp") setFormat(topic, FMT_MSGPACK);
+    else if (fmt == "text")              setFormat(topic, FMT_TEXT);
+    else if (fmt == "zip" && zip_enabled) setFormat(topic, FMT_ZIP);
+    else if (fmt == "zip") {
+        Dev_log::println("[codec] 압축이 빠진 구성입니다");
+        return true;
+    }
+    else {
+        Dev_log::printf("[codec] 알 수 없는 형식: %s\n", fmt.c_str());
+        return true;
+    }
+
+    Dev_log::printf("[codec] %s → %s\n", topic.c_str(), fmt.c_str());
+
+    return true;
+}
+
+// doc를 MSGPACK으로 직렬화 ( text_len: 같은 내용을 TEXT로 보냈을 때의 크기, 비교용 )
+size_t Payload_codec::encode(JsonDocument& doc, std::vector<uint8_t>& out, size_t text_len) {
+    uint32_t begin = micros();
+
+    out.resize(measureMsgPack(doc));
+    size_t len = serializeMsgPack(doc, out.data(), out.size());
+
+    enc_us     += micros() - begin;
+    enc_cnt    += 1;
+    bin_bytes  += len;
+    text_bytes += text_len;
+
+    return len;
+}
+
+// 누적 측정값 출력용 문자열
+String Payload_codec::stats() {
+    char tmp[128]; memset(tmp, '\0', 128);
+
+    sprintf(tmp, "encode: %u msgs, avg %u us\nsize: %u byte (text %u byte, %u%%)",
+        enc_cnt,
+        enc_cnt ? enc_us / enc_cnt : 0,
+        bin_bytes,
+        text_bytes,
+        text_bytes ? (uint32_t)(100ULL * bin_bytes / text_bytes) : 0
+    );
+
+    return tmp;
+}
+
+Payload_codec& codec = Payload_codec::GetInstance();
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef PAYLOAD_DECODER_H
+#define PAYLOAD_DECODER_H
+
+/* 개요: MSGPACK 형식으로 받은 메시지를 수신측(서버)에서 해석하는 헤더 입니다.
+ * --------------------------------------------
+ * 1. Arduino에 의존하지 않으므로 서버, 테스트에서 그대로 include 해서 사용합니다 ( test/test_codec 참고 )
+ * 2. "[기기이름] " 접두사를 떼고, [스키마ID, 필드...] 배열을 스키마 표에 따라 이름 붙은 JSON으로 바꿉니다
+ *    - ex) [3, "home", -52, 16820416] → {"schema":"net","ssid":"home","rssi":-52,"ip":"192.168.0.1"}
+ *    - ip는 IPAddress를 uint32로 변환한 값이므로 점 표기로 바꿔 출력 ( 첫 옥텟이 최하위 바이트 )
+ *    - SCAN 처럼 필드가 반복되는 스키마는 묶어서 배열로 출력
+ *    - 모르는 스키마는 {"schema":<ID>,"fields":[...]} 로 출력
+ * 3. 스키마 ID와 필드 순서는 기기측( Payload_codec.h )과 이 헤더가 함께 사용합니다
+ * 4. 명령 응답처럼 정해진 필드가 없는 문자열은 SCHEMA_TEXT 로 보냅니다 ( {"schema":"text","text":"..."} )
+ * 5. 여러 파일에서 include 해도 되도록 함수는 모두 inline 입니다
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// 스키마 ID ( MSGPACK 배열의 첫번째 원소 )
+enum Payload_schema {
+    SCHEMA_WAKEUP = 1,  // [1, ip]
+    SCHEMA_LFS    = 2,  // [2, total, used]
+    SCHEMA_NET    = 3,  // [3, ssid, rssi, ip]
+    SCHEMA_SCAN   = 4,  // [4, ssid, rssi, secured, ssid, rssi, secured, ...]
+    SCHEMA_AGG    = 5,  // [5, name, window_ms, count, min, max, mean, p50, p90, p99]
+    SCHEMA_TEXT   = 6   // [6, text] ( 명령 응답 등 자유 형식 문자열 )
+};
+
+// 스키마 별 필드 이름 ( repeat: 필드가 반복되면 묶을 배열 이름 )
+typedef struct Payload_layout {
+    uint8_t     id;
+    const char* name;
+    const char* fields[9];
+    uint8_t     field_cnt;
+    const char* repeat;
+} Payload_layout;
+
+static const Payload_layout payload_layouts[] = {
+    { SCHEMA_WAKEUP, "wakeup", { "ip" },                                                         1, nullptr    },
+    { SCHEMA_LFS,    "lfs",    { "total", "used" },                                              2, nullptr    },
+    { SCHEMA_NET,    "net",    { "ssid", "rssi", "ip" },                                         3, nullptr    },
+    { SCHEMA_SCAN,   "scan",   { "ssid", "rssi", "secured" },                                    3, "networks" },
+    { SCHEMA_AGG,    "agg",    { "m", "w", "n", "min", "max", "mean", "p50", "p90", "p99" },     9, nullptr    },
+    { SCHEMA_TEXT,   "text",   { "text" },                                                       1, nullptr    }
+};
+
+// MessagePack 값 하나
+typedef struct Mp_value {
+    enum { NIL, BOOL, INT, FLOAT, STR, ARRAY, MAP } type;
+    int64_t  i;         // BOOL, INT ( uint64 범위를 넘는 값은 없다고 가정 )
+    double   f;
+    std::string s;      // STR ( bin도 문자열로 취급 )
+    std::vector<Mp_value> items;    // ARRAY, MAP ( MAP은 키, 값 순서로 )
+} Mp_value;
+
+// MessagePack 해석 ( 잘못되거나 잘린 데이터면 false )
+class Mp_reader {
+    private:
+        const uint8_t* p;
+        const uint8_t* end;
+
+        bool take(size_t n, const uint8_t*& out) {
+            if ((size_t)(end - p) < n) return false;
+
+            out = p;
+            p  += n;
+
+            return true;
+        }
+
+        bool be(size_t n, uint64_t& out) {
+            const uint8_t* b;
+
+            if (!take(n, b)) return false;
+
+            out = 0;
+            for (size_t i = 0; i < n; i++) out = (out << 8) | b[i];
+
+            return true;
+        }
+
+        bool str(size_t n, Mp_value& v) {
+            const uint8_t* b;
+
+            if (!take(n, b)) return false;
+
+            v.type = Mp_value::STR;
+            v.s.assign((const char*)b, n);
+
+            return true;
+        }
+
+        bool list(size_t n, Mp_value& v, int depth) {
+            v.items.resize(n);
+
+            for (size_t i = 0; i < n; i++)
+                if (!read(v.items[i], depth + 1)) return false;
+
+            return true;
+        }
+
+    public:
+        Mp_reader(const uint8_t* data, size_t len) : p(data), end(data + len) {}
+
+        bool done() { return p == end; }
+
+        bool read(Mp_value& v, int depth = 0) {
+            uint64_t n;
+            const uint8_t* b;
+
+            if (16 < depth || !take(1, b)) return false;
+
+            uint8_t c = *b;
+
+            v.type = Mp_value::INT;
+
+            if (c <= 0x7f) { v.i = c;             return true; }
+            if (0xe0 <= c) { v.i = (int8_t)c;     return true; }
+            if ((c & 0xe0) == 0xa0) return str(c & 0x1f, v);
+            if ((c & 0xf0) == 0x90) { v.type = Mp_value::ARRAY; return list(c & 0x0f, v, depth); }
+            if ((c & 0xf0) == 0x80) { v.type = Mp_value::MAP;   return list((c & 0x0f) * 2, v, depth); }
+
+            switch (c) {
+                case 0xc0: v.type = Mp_value::NIL;             return true;
+                case 0xc2: v.type = Mp_value::BOOL; v.i = 0;   return true;
+                case 0xc3: v.type = Mp_value::BOOL; v.i = 1;   return true;
+                case 0xc4: case 0xd9: return be(1, n) && str(n, v);
+                case 0xc5: case 0xda: return be(2, n) && str(n, v);
+                case 0xc6: case 0xdb: return be(4, n) && str(n, v);
+                case 0xca: {
+                    float f; uint32_t bits;
+
+                    if (!be(4, n)) return false;
+                    bits = (uint32_t)n;
+                    memcpy(&f, &bits, 4);
+                    v.type = Mp_value::FLOAT; v.f = f;
+
+                    return true;
+                }
+                case 0xcb: {
+                    if (!be(8, n)) return false;
+                    memcpy(&v.f, &n, 8);
+                    v.type = Mp_value::FLOAT;
+
+                    return true;
+                }
+                case 0xcc: if (!be(1, n)) return false; v.i = (int64_t)n;          return true;
+                case 0xcd: if (!be(2, n)) return false; v.i = (int64_t)n;          return true;
+                case 0xce: if (!be(4, n)) return false; v.i = (int64_t)n;          return true;
+                case 0xcf: if (!be(8, n)) return false; v.i = (int64_t)n;          return true;
+                case 0xd0: if (!be(1, n)) return false; v.i = (int8_t)n;           return true;
+                case 0xd1: if (!be(2, n)) return false; v.i = (int16_t)n;          return true;
+                case 0xd2: if (!be(4, n)) return false; v.i = (int32_t)n;          return true;
+                case 0xd3: if (!be(8, n)) return false; v.i = (int64_t)n;          return true;
+                case 0xdc: v.type = Mp_value::ARRAY; return be(2, n) && list(n, v, depth);
+                case 0xdd: v.type = Mp_value::ARRAY; return be(4, n) && list(n, v, depth);
+                case 0xde: v.type = Mp_value::MAP;   return be(2, n) && list(n * 2, v, depth);
+                case 0xdf: v.type = Mp_value::MAP;   return be(4, n) && list(n * 2, v, depth);
+                default:   return false;    // ext 타입은 사용하지 않음
+            }
+        }
+};
+
+// JSON 문자열로 ( 따옴표 포함 )
+inline void mp_json_string(const std::string& s, std::string& out) {
+    char tmp[8];
+
+    out += '"';
+
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if (c < 0x20) { snprintf(tmp, sizeof(tmp), "\\u%04x", c); out += tmp; }
+        else out += c;
+    }
+
+    out += '"';
+}
+
+// 값을 JSON으로 ( ip: 점 표기로 출력 )
+inline void mp_json(const Mp_value& v, std::string& out, bool ip = false) {
+    char tmp[32];
+
+    switch (v.type) {
+        case Mp_value::NIL:   out += "null"; break;
+        case Mp_value::BOOL:  out += v.i ? "true" : "false"; break;
+        case Mp_value::INT:
+            if (ip) snprintf(tmp, sizeof(tmp), "\"%u.%u.%u.%u\"",
+                        (unsigned)(v.i & 0xff), (unsigned)(v.i >> 8 & 0xff), (unsigned)(v.i >> 16 & 0xff), (unsigned)(v.i >> 24 & 0xff));
+            else    snprintf(tmp, sizeof(tmp), "%lld", (long long)v.i);
+            out += tmp;
+            break;
+        case Mp_value::FLOAT:
+            snprintf(tmp, sizeof(tmp), "%.9g", v.f);
+            out += tmp;
+            break;
+        case Mp_value::STR:   mp_json_string(v.s, out); break;
+        case Mp_value::ARRAY:
+            out += '[';
+            for (size_t i = 0; i < v.items.size(); i++) {
+                if (i) out += ',';
+                mp_json(v.items[i], out);
+            }
+            out += ']';
+            break;
+        case Mp_value::MAP:
+            out += '{';
+            for (size_t i = 0; i + 1 < v.items.size(); i += 2) {
+                if (i) out += ',';
+                if (v.items[i].type == Mp_value::STR) mp_json_string(v.items[i].s, out);
+                else { std::string key; mp_json(v.items[i], key); mp_json_string(key, out); }
+                out += ':';
+                mp_json(v.items[i + 1], out);
+            }
+            out += '}';
+            break;
+    }
+}
+
+// 필드 이름: 값, ... ( from 부터 layout.field_cnt 개 )
+inline void payload_fields(const Payload_layout& layout, const std::vector<Mp_value>& items, size_t from, std::string& out) {
+    for (uint8_t k = 0; k < layout.field_cnt; k++) {
+        if (k) out += ',';
+
+        mp_json_string(layout.fields[k], out);
+        out += ':';
+        mp_json(items[from + k], out, strcmp(layout.fields[k], "ip") == 0);
+    }
+}
+
+// 수신한 페이로드를 JSON으로 ( device: 접두사의 기기이름, 형식이 맞지 않으면 false )
+inline bool payload_decode(const uint8_t* payload, size_t len, std::string& device, std::string& json) {
+    device.clear();
+    json.clear();
+
+    // "[기기이름] " 접두사
+    if (len && payload[0] == '[') {
+        const uint8_t* close = (const uint8_t*)memchr(payload, ']', len);
+
+        if (!close || (size_t)(close - payload) + 2 > len || close[1] != ' ') return false;
+
+        device.assign((const char*)payload + 1, close - payload - 1);
+        len    -= close + 2 - payload;
+        payload = close + 2;
+    }
+
+    Mp_reader reader(payload, len);
+    Mp_value root;
+
+    if (!reader.read(root) || !reader.done()) return false;
+    if (root.type != Mp_value::ARRAY || root.items.empty() || root.items[0].type != Mp_value::INT) return false;
+
+    const Payload_layout* layout = nullptr;
+    size_t rest = root.items.size() - 1;
+
+    for (const Payload_layout& l : payload_layouts)
+        if (l.id == root.items[0].i) layout = &l;
+
+    // 모르는 스키마거나 필드 수가 맞지 않으면 이름 없이 그대로
+    if (!layout || (layout->repeat ? rest % layout->field_cnt : rest != layout->field_cnt)) {
+        Mp_value fields;
+
+        fields.type = Mp_value::ARRAY;
+        fields.items.assign(root.items.begin() + 1, root.items.end());
+
+        json = "{\"schema\":" + std::to_string(root.items[0].i) + ",\"fields\":";
+        mp_json(fields, json);
+        json += '}';
+
+        return true;
+    }
+
+    json = "{\"schema\":";
+    mp_json_string(layout->name, json);
+    json += ',';
+
+    if (layout->repeat) {
+        mp_json_string(layout->repeat, json);
+        json += ":[";
+
+        for (size_t i = 1; i < root.items.size(); i += layout->field_cnt) {
+            if (1 < i) json += ',';
+
+            json += '{';
+            payload_fields(*layout, root.items, i, json);
+            json += '}';
+        }
+
+        json += ']';
+    } else {
+        payload_fields(*layout, root.items, 1, json);
+    }
+
+    json += '}';
+
+    return true;
+}
+
+#endif
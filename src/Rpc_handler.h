@@ -0,0 +1,247 @@
+#ifndef RPC_HANDLER_H
+#define RPC_HANDLER_H
+
+/* 개요: MQTT 위에서 요청/응답(RPC)을 처리하는 헤더 입니다.
+ * --------------------------------------------
+ * 1. "rpc/<기기이름>/req" 로 요청을 받고 "rpc/<기기이름>/res" 로 응답합니다
+ * 2. 요청마다 id가 있어 응답과 짝을 맞출 수 있고, 최대 RPC_MAX_INFLIGHT 개 까지 동시에 처리합니다
+ * 3. 수신 콜백에서는 보관만 하고, 실제 처리는 loop()에서 Dev::Rpc::run()으로 합니다
+ * 4. 바로 끝나지 않는 메소드는 RPC_PENDING을 반환하고 poll 함수로 완료를 알립니다
+ * 5. timeout(ms) 안에 끝나지 않으면 RPC_ERR_TIMEOUT 으로 응답합니다
+ *
+ * 메시지 형식 ( JSON )
+ * --------------------------------------------
+ * - 요청: {"id": 1, "method": "lfs", "params": {...}, "timeout": 5000}   ( params, timeout 생략 가능 )
+ * - 응답: {"id": 1, "code": 0, "result": {...}}  /  {"id": 1, "code": 2, "error": "unknown method"}
+*/
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <env.h>
+#include <functional>
+#include <map>
+
+#define RPC_MAX_INFLIGHT    8
+#define RPC_DEFAULT_TIMEOUT 10000
+
+// 응답 코드 ( RPC_PENDING은 메소드 내부용으로 응답되지 않음 )
+enum Rpc_code {
+    RPC_PENDING      = -1,
+    RPC_OK           = 0,
+    RPC_ERR_PARSE    = 1,
+    RPC_ERR_METHOD   = 2,
+    RPC_ERR_BUSY     = 3,
+    RPC_ERR_TIMEOUT  = 4,
+    RPC_ERR_PARAMS   = 5,
+    RPC_ERR_INTERNAL = 6
+};
+
+struct Rpc_call;
+
+// 메소드 ( 반환: Rpc_code, 인자: 호출 정보, 결과를 채울 객체 )
+typedef std::function<int(Rpc_call&, JsonObject)> Rpc_method;
+
+// 응답 송신 함수 ( 인자: 토픽, 메시지 )
+typedef std::function<void(const char*, const String&)> Rpc_sender;
+
+// 처리 중인 호출 1건
+typedef struct Rpc_call {
+    bool         used;
+    bool         started;
+    uint32_t     id;
+    String       method;
+    JsonDocument params;
+    uint32_t     begin_ms;
+    uint32_t     timeout;
+    Rpc_method   poll;       // RPC_PENDING 이후 완료 여부를 확인할 함수
+} Rpc_call;
+
+class Rpc_handler {
+    private:
+        Rpc_call calls[RPC_MAX_INFLIGHT];
+        std::map<String, Rpc_method> methods;
+
+        String in_topic;
+        String out_topic;
+        Rpc_sender sender;
+
+        void reply(uint32_t id, int code, const char* error, JsonDocument* result = nullptr);
+        void finish(Rpc_call& call, int code, JsonDocument& result);
+
+    public:
+        Rpc_handler() = default;
+        Rpc_handler& operator=(const Rpc_handler& ref) = delete;
+        static Rpc_handler& GetInstance();
+
+        // 초기화 ( 응답을 내보낼 함수 등록 )
+        void init(Rpc_sender sender);
+
+        // 메소드 등록
+        void reg_method(String name, Rpc_method fn);
+
+        // 구독할 토픽
+        String getTopic() { return in_topic; }
+
+        // 처리 중인 호출 수
+        int inflight();
+
+        // 수신 메시지 보관 ( RPC 토픽이 아니면 false )
+        bool handle(const char* topic, const uint8_t* payload, unsigned int length);
+
+        // non-blocking 실행 ( 보관된 호출 처리 및 타임아웃 )
+        void run();
+};
+
+Rpc_handler& Rpc_handler::GetInstance() {
+    static Rpc_handler instance;
+
+    return instance;
+}
+
+// 초기화 ( 응답을 내보낼 함수 등록 )
+void Rpc_handler::init(Rpc_sender sender) {
+    this->sender = sender;
+    in_topic  = "rpc/" + env.getName() + "/req";
+    out_topic = "rpc/" + env.getName() + "/res";
+
+    for (Rpc_call& call : calls) call.used = false;
+}
+
+// 메소드 등록
+void Rpc_handler::reg_method(String name, Rpc_method fn) {
+    methods[name] = fn;
+}
+
+// 처리 중인 호출 수
+int Rpc_handler::inflight() {
+    int cnt = 0;
+
+    for (Rpc_call& call : calls) if (call.used) cnt++;
+
+    return cnt;
+}
+
+void Rpc_handler::reply(uint32_t id, int code, const char* error, JsonDocument* result) {
+    JsonDocument doc;
+    String msg;
+
+    doc["id"]   = id;
+    doc["code"] = code;
+
+    if (code != RPC_OK && error) doc["error"] = error;
+    if (code == RPC_OK && result) doc["result"] = *result;
+
+    serializeJson(doc, msg);
+    sender(out_topic.c_str(), msg);
+}
+
+void Rpc_handler::finish(Rpc_call& call, int code, JsonDocument& result) {
+    const char* error = nullptr;
+
+    switch (code) {
+        case RPC_ERR_PARAMS:   error = "invalid params"; break;
+        case RPC_ERR_INTERNAL: error = "internal error"; break;
+        default: break;
+    }
+
+    reply(call.id, code, error, &result);
+
+    call.used   = false;
+    call.poll   = nullptr;
+    call.params.clear();
+}
+
+// 수신 메시지 보관 ( RPC 토픽이 아니면 false )
+bool Rpc_handler::handle(const char* topic, const uint8_t* payload, unsigned int length) {
+    if (in_topic != topic) return false;
+
+    JsonDocument req;
+
+    if (deserializeJson(req, payload, length) || !req["id"].is<uint32_t>() || !req["method"].is<const char*>()) {
+        reply(req["id"] | 0, RPC_ERR_PARSE, "parse error");
+        return true;
+    }
+
+    uint32_t id = req["id"];
+    Rpc_call* slot = nullptr;
+
+    for (Rpc_call& call : calls) {
+        // 같은 id가 처리 중이면 재전송된 요청으로 보고 무시
+        if (call.used && call.id == id) return true;
+        if (!call.used && !slot) slot = &call;
+    }
+
+    if (!slot) {
+        reply(id, RPC_ERR_BUSY, "too many calls in flight");
+        return true;
+    }
+
+    slot->used     = true;
+    slot->started  = false;
+    slot->id       = id;
+    slot->method   = req["method"].as<String>();
+    slot->params   = req["params"];
+    slot->begin_ms = millis();
+    slot->timeout  = req["timeout"] | RPC_DEFAULT_TIMEOUT;
+    slot->poll     = nullptr;
+
+    return true;
+}
+
+// non-blocking 실행 ( 보관된 호출 처리 및 타임아웃 )
+void Rpc_handler::run() {
+    for (Rpc_call& call : calls) {
+        if (!call.used) continue;
+
+        JsonDocument result;
+        JsonObject obj = result.to<JsonObject>();
+        int code = RPC_PENDING;
+
+        if (!call.started) {
+            auto iter = methods.find(call.method);
+
+            call.started = true;
+
+            if (iter == methods.end()) {
+                reply(call.id, RPC_ERR_METHOD, "unknown method");
+                call.used = false;
+                call.params.clear();
+                continue;
+            }
+
+            code = iter->second(call, obj);
+        } else if (call.poll) {
+            code = call.poll(call, obj);
+        }
+
+        if (code != RPC_PENDING) {
+            finish(call, code, result);
+            continue;
+        }
+
+        if (call.timeout < millis() - call.begin_ms) {
+            reply(call.id, RPC_ERR_TIMEOUT, "timeout");
+            call.used = false;
+            call.poll = nullptr;
+            call.params.clear();
+        }
+    }
+}
+
+// Device_config.h 의 RPC 정책
+struct Rpc_on {
+    static void init(Rpc_sender sender) { Rpc_handler::GetInstance().init(sender); }
+    static void reg_method(const char* name, Rpc_method fn) { Rpc_handler::GetInstance().reg_method(name, fn); }
+
+    template <typename C>
+    static void subscribe(C& client) { client.subscribe(Rpc_handler::GetInstance().getTopic().c_str()); }
+
+    static bool handle(const char* topic, const uint8_t* payload, unsigned int length) {
+        return Rpc_handler::GetInstance().handle(topic, payload, length);
+    }
+
+    static int inflight() { return Rpc_handler::GetInstance().inflight(); }
+    static void run() { Rpc_handler::GetInstance().run(); }
+};
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+/* 개요: 센서를 주기적으로 읽어 블록 단위로 모으는 헤더 입니다.
+ * --------------------------------------------
+ * 1. 전용 태스크가 일정 주기로 등록된 채널(버스)을 읽습니다 ( loop()를 막지 않음 )
+ * 2. 블록 2개를 번갈아 채우고, 찬 블록은 복사 없이 그대로 loop()에 넘깁니다
+ * 3. loop()가 블록을 돌려주지 않아 채울 블록이 없으면 샘플을 버리고 overrun을 셉니다
+ * 4. 실제 샘플 간격을 측정해 지터(최소/최대/평균 오차)를 기록합니다
+ * 5. 버스는 Sample_bus 로 추상화 되어 있어, 가짜 버스로 바꿔 처리량/지터를 측정할 수 있습니다
+ * 6. 블록 채우기/overrun/지터 계산은 플랫폼 독립인 Sampler_core.h 에 있고, 이 헤더는 ESP32 구현만 담습니다
+ *    - I2C_bus / SPI_bus   : Adafruit_BusIO 로 레지스터를 읽는 버스
+ *    - ADC_bus             : 내장 ADC 핀 전압(mV)을 읽는 버스 ( 외부 센서 없이 쓸 수 있는 기본 채널, HW_config.h 의 SAMPLE_ADC_PIN )
+ *    - Sample_rtos_slots   : 블록 번호를 FreeRTOS 큐로 주고받음
+ *    - Sampler             : 전용 태스크가 vTaskDelayUntil 주기마다 Sampler_core::tick(esp_timer) 호출
+ *    - 주기는 1 tick( portTICK_PERIOD_MS ) 이상이어야 하며, 0이나 그보다 짧으면 begin()이 false
+ * 7. 채널 값은 블록마다 숫자로 꺼내 집계( Aggregator.h )에 넣을 수 있습니다 ( Sample_type 참고 )
+ *
+ * 블록 형식 ( 리틀엔디안, 그대로 publish 됨 )
+ * --------------------------------------------
+ * [seq 4][t0_us 4][period_us 4][count 2][size 2][data: 샘플 count개, 샘플 = 채널 순서대로 이어붙인 바이트]
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <Adafruit_I2CDevice.h>
+#include <Adafruit_SPIDevice.h>
+#include <esp_timer.h>
+#include <Log_config.h>
+#include <Sampler_core.h>
+
+#define SAMPLE_TASK_CORE    1
+#define SAMPLE_TASK_PRIO    2   // loop()(1) 보다 높게
+
+// I2C 장치의 레지스터를 읽는 버스
+class I2C_bus : public Sample_bus {
+    private:
+        Adafruit_I2CDevice dev;
+        uint8_t reg;
+
+    public:
+        I2C_bus(uint8_t addr, uint8_t reg, TwoWire* wire = &Wire) : dev(addr, wire), reg(reg) {}
+
+        bool begin() override { return dev.begin(); }
+
+        bool read(uint8_t* dst, size_t len) override { return dev.write_then_read(&reg, 1, dst, len); }
+};
+
+// SPI 장치의 레지스터를 읽는 버스
+class SPI_bus : public Sample_bus {
+    private:
+        Adafruit_SPIDevice dev;
+        uint8_t reg;
+
+    public:
+        SPI_bus(int8_t cs, uint8_t reg, uint32_t freq = 1000000) : dev(cs, freq), reg(reg) {}
+
+        bool begin() override { return dev.begin(); }
+
+        bool read(uint8_t* dst, size_t len) override { return dev.write_then_read(&reg, 1, dst, len); }
+};
+
+// 내장 ADC 핀 전압을 읽는 버스 ( mV, uint16 리틀엔디안 2byte )
+class ADC_bus : public Sample_bus {
+    private:
+        uint8_t pin;
+
+    public:
+        ADC_bus(uint8_t pin) : pin(pin) {}
+
+        // ADC 핀이 아니면 실패 ( WiFi 사용 중에는 ADC1 핀만 읽힘 )
+        bool begin() override {
+            if (digitalPinToAnalogChannel(pin) < 0) return false;
+
+            analogSetPinAttenuation(pin, ADC_11db);   // 0 ~ 약 3.1V
+
+            return true;
+        }
+
+        bool read(uint8_t* dst, size_t len) override {
+            if (len != 2) return false;
+
+            uint16_t mv = analogReadMilliVolts(pin);
+
+            dst[0] = mv & 0xFF;
+            dst[1] = mv >> 8;
+
+            return true;
+        }
+};
+
+// 샘플링 태스크와 loop() 사이에서 블록 번호를 주고받는 FreeRTOS 큐
+class Sample_rtos_slots : public Sample_slots {
+    private:
+        QueueHandle_t free_q;     // 채울 수 있는 블록 번호
+        QueueHandle_t ready_q;    // 다 찬 블록 번호
+
+    public:
+        Sample_rtos_slots() : free_q(nullptr), ready_q(nullptr) {}
+
+        // 처음 쓸 때 큐 생성
+        void reset() override {
+            if (!free_q) {
+                free_q  = xQueueCreate(2, sizeof(uint8_t));
+                ready_q = xQueueCreate(2, sizeof(uint8_t));
+            }
+
+            xQueueReset(free_q);
+            xQueueReset(ready_q);
+            for (uint8_t i = 0; i < 2; i++) xQueueSend(free_q, &i, 0);
+        }
+
+        bool pop_free(uint8_t& idx) override { return xQueueReceive(free_q, &idx, 0) == pdTRUE; }
+        void push_free(uint8_t idx) override { xQueueSend(free_q, &idx, 0); }
+        bool pop_ready(uint8_t& idx) override { return xQueueReceive(ready_q, &idx, 0) == pdTRUE; }
+        void push_ready(uint8_t idx) override { xQueueSend(ready_q, &idx, 0); }
+};
+
+class Sampler {
+    private:
+        Sample_rtos_slots slots;
+        Sampler_core      core;
+        TaskHandle_t      task;
+
+        static void sample_task(void* arg);
+
+    public:
+        Sampler() : core(&slots), task(nullptr) {}
+        Sampler& operator=(const Sampler& ref) = delete;
+        static Sampler& GetInstance();
+        void init();
+
+        // 채널 추가 ( 샘플마다 bus에서 len 바이트를 읽음, type: 값 형식 )
+        bool add_channel(Sample_bus* bus, uint8_t len, uint8_t type = SAMPLE_INT_BE);
+
+        // 샘플링 시작 ( 채널이 없거나, 주기가 0이거나 1 tick 보다 짧으면 false )
+        bool begin(uint32_t period_ms);
+
+        // 다 찬 블록 가져오기 ( 없으면 nullptr, 다 쓰면 release 필요 )
+        Sample_block* take() { return core.take(); }
+
+        // 다 쓴 블록 돌려주기
+        void release(Sample_block* block) { core.release(block); }
+
+        // 블록의 채널 값마다 fn(채널 번호, 값) 호출
+        template <typename F>
+        void for_each(const Sample_block* block, F fn) { core.for_each(block, fn); }
+
+        // 측정값 출력용 문자열
+        String stats();
+};
+
+Sampler& Sampler::GetInstance() {
+    static Sampler instance;
+
+    return instance;
+}
+
+void Sampler::init() {
+    if (!task) core.init();
+}
+
+// 채널 추가 ( 샘플마다 bus에서 len 바이트를 읽음, type: 값 형식 )
+bool Sampler::add_channel(Sample_bus* bus, uint8_t len, uint8_t type) {
+    if (core.add_channel(bus, len, type)) return true;
+
+    Dev_log::println("[Sampler] 채널 추가 실패 ( 시작 후, 개수/크기 초과 또는 버스 초기화 실패 )");
+
+    return false;
+}
+
+// 샘플링 시작 ( 채널이 없거나, 주기가 0이거나 1 tick 보다 짧으면 false )
+bool Sampler::begin(uint32_t period_ms) {
+    if (task || !core.start(period_ms, portTICK_PERIOD_MS * 1000)) {
+        Dev_log::printf("[Sampler] 시작 실패 ( 주기 %ums, 최소 %ums )\n", period_ms, portTICK_PERIOD_MS);
+        return false;
+    }
+
+    xTaskCreatePinnedToCore(sample_task, "sampler", 4096, this, SAMPLE_TASK_PRIO, &task, SAMPLE_TASK_CORE);
+
+    return true;
+}
+
+// 샘플링 태스크: 주기마다 core 에 현재 시각을 넘김
+void Sampler::sample_task(void* arg) {
+    Sampler* self = (Sampler*)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t period = self->core.period() / (portTICK_PERIOD_MS * 1000);
+
+    for (;;) {
+        vTaskDelayUntil(&last_wake, period);
+
+        self->core.tick(esp_timer_get_time());
+    }
+}
+
+// 측정값 출력용 문자열
+String Sampler::stats() {
+    char tmp[160];
+
+    core.stats(tmp, sizeof(tmp));
+
+    return tmp;
+}
+
+// Device_config.h 의 샘플러 정책
+struct Sample_on {
+    static void init() { Sampler::GetInstance().init(); }
+    static bool add_channel(Sample_bus* bus, uint8_t len, uint8_t type = SAMPLE_INT_BE) {
+        return Sampler::GetInstance().add_channel(bus, len, type);
+    }
+    static bool begin(uint32_t period_ms) { return Sampler::GetInstance().begin(period_ms); }
+
+    // 내장 ADC 핀을 채널로 추가 ( 버스는 한번 만들어 계속 사용 )
+    static bool add_adc(uint8_t pin) {
+        ADC_bus* bus = new ADC_bus(pin);
+
+        if (add_channel(bus, 2, SAMPLE_UINT_LE)) return true;
+
+        delete bus;
+
+        return false;
+    }
+
+    // 다 찬 블록이 있으면 채널 값마다 on_value(채널 번호, 값), 블록은 on_block(헤더+데이터, 길이) 호출 후 반환
+    template <typename V, typename F>
+    static void run(V on_value, F on_block) {
+        Sample_block* block = Sampler::GetInstance().take();
+
+        if (!block) return;
+
+        Sampler::GetInstance().for_each(block, on_value);
+        on_block((const uint8_t*)block, SAMPLE_HEADER_SIZE + block->size);
+        Sampler::GetInstance().release(block);
+    }
+
+    static String stats() { return Sampler::GetInstance().stats(); }
+};
+
+#endif
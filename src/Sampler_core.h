@@ -0,0 +1,302 @@
+#ifndef SAMPLER_CORE_H
+#define SAMPLER_CORE_H
+
+/* 개요: 샘플링 주기마다 채널을 읽어 블록에 모으는 동작만 담은 헤더 입니다. ( 플랫폼 독립 )
+ * --------------------------------------------
+ * 1. Arduino/FreeRTOS/esp_timer 에 의존하지 않으며, 플랫폼 기능은 아래 인터페이스로 주입받습니다
+ *    - Sample_bus   : 샘플을 읽어올 버스 ( ESP32: I2C_bus / SPI_bus, 호스트: 가짜 버스 )
+ *    - Sample_slots : 블록 번호를 주고받는 큐 2개 ( ESP32: FreeRTOS 큐, 호스트: std::deque )
+ * 2. 주기 타이머는 플랫폼 쪽에서 돌리고, 주기마다 tick(현재 시각) 을 호출합니다
+ * 3. ESP32 구현은 Sampler.h, 호스트 구현은 test/host/Sample_host.h, 테스트는 test/test_sampler 에 있습니다
+ * 4. 블록 형식과 overrun/지터 규칙은 Sampler.h 참고
+ * 5. 채널마다 값 형식( Sample_type )을 지정하면 for_each() 로 샘플 값을 숫자로 꺼낼 수 있습니다 ( 집계 입력용 )
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define SAMPLE_BLOCK_SIZE   512
+#define SAMPLE_MAX_CHANNEL  4
+
+// 채널 값 형식 ( 1, 2, 4 바이트 정수만 숫자로 해석, SAMPLE_RAW 는 해석하지 않음 )
+enum Sample_type : uint8_t {
+    SAMPLE_RAW    = 0,
+    SAMPLE_INT_BE = 1,  // 부호 있는 정수, 상위 바이트 먼저 ( 대부분의 센서 레지스터 )
+    SAMPLE_UINT_BE,
+    SAMPLE_INT_LE,
+    SAMPLE_UINT_LE
+};
+
+// 샘플을 읽어올 버스
+class Sample_bus {
+    public:
+        virtual ~Sample_bus() = default;
+
+        // 장치 초기화 ( 실패 시 false )
+        virtual bool begin() = 0;
+
+        // len 바이트 읽기 ( 실패 시 false )
+        virtual bool read(uint8_t* dst, size_t len) = 0;
+};
+
+// 블록 번호를 주고받는 큐 ( free: 채울 수 있는 블록, ready: 다 찬 블록, 기다리지 않음 )
+class Sample_slots {
+    public:
+        virtual ~Sample_slots() = default;
+
+        // 비우고 블록 0, 1 을 free 로
+        virtual void reset() = 0;
+
+        virtual bool pop_free(uint8_t& idx) = 0;
+        virtual void push_free(uint8_t idx) = 0;
+        virtual bool pop_ready(uint8_t& idx) = 0;
+        virtual void push_ready(uint8_t idx) = 0;
+};
+
+// 샘플 블록 ( 헤더 + 데이터를 그대로 전송 )
+typedef struct Sample_block {
+    uint32_t seq;
+    uint32_t t0_us;       // 첫 샘플 시각
+    uint32_t period_us;   // 샘플 주기
+    uint16_t count;       // 샘플 수
+    uint16_t size;        // data 사용 크기
+    uint8_t  data[SAMPLE_BLOCK_SIZE];
+} Sample_block;
+
+#define SAMPLE_HEADER_SIZE offsetof(Sample_block, data)
+
+typedef struct Sample_channel {
+    Sample_bus* bus;
+    uint8_t     len;
+    uint8_t     type;   // Sample_type
+} Sample_channel;
+
+class Sampler_core {
+    private:
+        Sample_slots* slots;
+
+        Sample_channel channels[SAMPLE_MAX_CHANNEL];
+        uint8_t  channel_cnt;
+        uint16_t sample_len;      // 샘플 1개 크기 ( 모든 채널 합 )
+        uint32_t period_us;
+        bool     isStarted;
+
+        // 더블 버퍼 ( 하나를 채우는 동안 다른 하나는 loop()가 전송 )
+        Sample_block blocks[2];
+        int      cur;             // 채우는 중인 블록 ( 없으면 -1 )
+        uint32_t seq;
+        int64_t  prev_us;
+
+        // 측정값 ( tick 에서 갱신, 다른 태스크에서 읽을 수 있음 )
+        volatile uint32_t sample_cnt;
+        volatile uint32_t overrun_cnt;
+        volatile uint32_t error_cnt;
+        volatile uint32_t jitter_min;
+        volatile uint32_t jitter_max;
+        volatile uint64_t jitter_sum;
+
+    public:
+        explicit Sampler_core(Sample_slots* slots) : slots(slots) { init(); }
+
+        void init();
+
+        // 채널 추가 ( 샘플마다 bus에서 len 바이트를 읽음, 시작 후엔 false )
+        bool add_channel(Sample_bus* bus, uint8_t len, uint8_t type = SAMPLE_INT_BE);
+
+        // 샘플링 시작 ( tick_us: 플랫폼 타이머 최소 단위, 채널이 없거나 주기가 tick보다 짧으면 false )
+        // 주기는 tick 단위로 내림 되며, 실제 주기는 period() 로 확인
+        bool start(uint32_t period_ms, uint32_t tick_us);
+
+        bool started() { return isStarted; }
+        uint32_t period() { return period_us; }
+
+        // 주기마다 호출 ( now_us: 현재 시각 )
+        void tick(int64_t now_us);
+
+        // 다 찬 블록 가져오기 ( 없으면 nullptr, 다 쓰면 release 필요 )
+        Sample_block* take();
+
+        // 다 쓴 블록 돌려주기
+        void release(Sample_block* block);
+
+        uint32_t samples()  { return sample_cnt; }
+        uint32_t overruns() { return overrun_cnt; }
+        uint32_t errors()   { return error_cnt; }
+
+        // 블록의 샘플마다, 숫자로 해석되는 채널마다 fn(채널 번호, 값) 호출
+        template <typename F>
+        void for_each(const Sample_block* block, F fn);
+
+        // 채널 값 해석 ( 숫자로 해석할 수 없으면 false )
+        static bool decode(const uint8_t* src, uint8_t len, uint8_t type, float& v);
+
+        // 측정값 출력용 문자열
+        void stats(char* out, size_t size);
+};
+
+void Sampler_core::init() {
+    channel_cnt = 0;
+    sample_len  = 0;
+    period_us   = 0;
+    isStarted   = false;
+    cur         = -1;
+    seq         = 0;
+    prev_us     = 0;
+    sample_cnt  = overrun_cnt = error_cnt = 0;
+    jitter_min  = UINT32_MAX;
+    jitter_max  = 0;
+    jitter_sum  = 0;
+}
+
+// 채널 추가 ( 샘플마다 bus에서 len 바이트를 읽음, 시작 후엔 false )
+bool Sampler_core::add_channel(Sample_bus* bus, uint8_t len, uint8_t type) {
+    if (isStarted || !bus || len == 0 || SAMPLE_MAX_CHANNEL <= channel_cnt || SAMPLE_BLOCK_SIZE < sample_len + len)
+        return false;
+
+    if (!bus->begin()) return false;
+
+    channels[channel_cnt++] = { bus, len, type };
+    sample_len += len;
+
+    return true;
+}
+
+// 샘플링 시작 ( tick_us: 플랫폼 타이머 최소 단위, 채널이 없거나 주기가 tick보다 짧으면 false )
+bool Sampler_core::start(uint32_t period_ms, uint32_t tick_us) {
+    uint64_t us = (uint64_t)period_ms * 1000;
+
+    if (isStarted || channel_cnt == 0 || tick_us == 0 || us < tick_us || UINT32_MAX < us) return false;
+
+    period_us = (uint32_t)(us / tick_us * tick_us);
+    isStarted = true;
+
+    slots->reset();
+
+    return true;
+}
+
+// 주기마다 호출: 모든 채널을 읽어 블록에 이어붙임
+void Sampler_core::tick(int64_t now_us) {
+    if (!isStarted) return;
+
+    // 실제 간격과 설정 주기의 차이를 지터로 기록
+    if (prev_us) {
+        int64_t diff = (now_us - prev_us) - period_us;
+        uint32_t jitter = diff < 0 ? -diff : diff;
+
+        if (jitter < jitter_min) jitter_min = jitter;
+        if (jitter_max < jitter) jitter_max = jitter;
+        jitter_sum += jitter;
+    }
+    prev_us = now_us;
+
+    // 채울 블록이 없으면 loop()가 돌려줄 때까지 샘플을 버림
+    if (cur < 0) {
+        uint8_t idx;
+
+        if (!slots->pop_free(idx)) {
+            overrun_cnt++;
+            return;
+        }
+
+        cur = idx;
+        blocks[cur].seq       = seq++;
+        blocks[cur].period_us = period_us;
+        blocks[cur].count     = 0;
+        blocks[cur].size      = 0;
+    }
+
+    Sample_block& block = blocks[cur];
+    uint8_t* dst = block.data + block.size;
+    bool ok = true;
+
+    if (block.count == 0) block.t0_us = (uint32_t)now_us;
+
+    for (uint8_t i = 0; i < channel_cnt && ok; i++) {
+        ok = channels[i].bus->read(dst, channels[i].len);
+        dst += channels[i].len;
+    }
+
+    if (!ok) {
+        error_cnt++;
+        return;
+    }
+
+    block.size += sample_len;
+    block.count++;
+    sample_cnt++;
+
+    // 다음 샘플이 들어갈 자리가 없으면 loop()로 넘김
+    if (SAMPLE_BLOCK_SIZE < block.size + sample_len) {
+        slots->push_ready(cur);
+        cur = -1;
+    }
+}
+
+// 다 찬 블록 가져오기 ( 없으면 nullptr, 다 쓰면 release 필요 )
+Sample_block* Sampler_core::take() {
+    uint8_t idx;
+
+    if (!isStarted || !slots->pop_ready(idx)) return nullptr;
+
+    return &blocks[idx];
+}
+
+// 다 쓴 블록 돌려주기
+void Sampler_core::release(Sample_block* block) {
+    slots->push_free(block - blocks);
+}
+
+// 블록의 샘플마다, 숫자로 해석되는 채널마다 fn(채널 번호, 값) 호출
+template <typename F>
+void Sampler_core::for_each(const Sample_block* block, F fn) {
+    const uint8_t* src = block->data;
+    float v;
+
+    for (uint16_t n = 0; n < block->count; n++) {
+        for (uint8_t i = 0; i < channel_cnt; i++) {
+            if (decode(src, channels[i].len, channels[i].type, v)) fn(i, v);
+
+            src += channels[i].len;
+        }
+    }
+}
+
+// 채널 값 해석 ( 숫자로 해석할 수 없으면 false )
+bool Sampler_core::decode(const uint8_t* src, uint8_t len, uint8_t type, float& v) {
+    if (type == SAMPLE_RAW || type > SAMPLE_UINT_LE || (len != 1 && len != 2 && len != 4)) return false;
+
+    bool big = type == SAMPLE_INT_BE || type == SAMPLE_UINT_BE;
+    uint32_t u = 0;
+
+    for (uint8_t k = 0; k < len; k++) u = (u << 8) | src[big ? k : len - 1 - k];
+
+    if (type == SAMPLE_UINT_BE || type == SAMPLE_UINT_LE) {
+        v = (float)u;
+        return true;
+    }
+
+    // 부호 확장
+    if (len < 4 && (u & (1u << (len * 8 - 1)))) u |= ~0u << (len * 8);
+
+    v = (float)(int32_t)u;
+
+    return true;
+}
+
+// 측정값 출력용 문자열
+void Sampler_core::stats(char* out, size_t size) {
+    uint32_t intervals = sample_cnt + overrun_cnt + error_cnt;
+
+    snprintf(out, size, "samples: %u, overrun: %u, error: %u\njitter(us): min %u, max %u, avg %u",
+        (unsigned)sample_cnt,
+        (unsigned)overrun_cnt,
+        (unsigned)error_cnt,
+        (unsigned)(jitter_min == UINT32_MAX ? 0 : jitter_min),
+        (unsigned)jitter_max,
+        intervals > 1 ? (unsigned)(jitter_sum / (intervals - 1)) : 0
+    );
+}
+
+#endif
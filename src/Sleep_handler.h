@@ -0,0 +1,326 @@
+#ifndef SLEEP_HANDLER_H
+#define SLEEP_HANDLER_H
+
+/* 개요: 보고 주기 사이에 절전(deep/light sleep)하는 duty-cycle 모드를 관리하는 헤더 입니다.
+ * --------------------------------------------
+ * 1. env.txt에 "sleep": {"interval": <초>, "mode": "deep"|"light"} 가 있을 때만 동작합니다
+ * 2. 접속 정보(AP, 채널, BSSID), 파싱된 설정, 보관 메시지, 토픽별 협상 형식을 RTC 메모리에 저장합니다
+ * 3. 타이머로 깨어나면 env.txt 파싱과 WiFi 스캔을 건너뛰고 바로 연결 → 전송 → 절전 합니다
+ * 4. 깨어난 뒤 전송까지 걸린 시간(wake-to-publish)을 측정해 다음 보고에 함께 보냅니다
+ * 5. SLEEP_AWAKE_TIMEOUT 안에 전송하지 못하면 접속 정보만 버리고 절전 ( 다음엔 처음부터 스캔 )
+ *    - 보관 메시지와 협상 형식은 유지되어, env.txt 부터 부팅해도 다시 보관/적용 됩니다
+ * 6. "awake" 명령을 받으면 재부팅 전까지 절전하지 않습니다 ( OTA 등 유지보수용 )
+ * 7. 새 펌웨어가 정상 판정 대기 중이면( Dev::Ota::pending() ) 빠른 복귀도 절전도 하지 않습니다
+ *    - 판정 시간( OTA_HEALTH_TIMEOUT )이 SLEEP_AWAKE_TIMEOUT 보다 길어 판정 전에 잠들면 롤백되기 때문
+ * 8. light sleep도 절전 전에 보관 메시지를 RTC로 옮기므로, 깨어나면 deep sleep 복귀와 같이 restore_net()으로 되돌립니다
+*/
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <env.h>
+#include <Network_config.h>
+
+#define SLEEP_MAGIC          0x534C5031
+#define SLEEP_AWAKE_TIMEOUT  15000   // 깨어난 뒤 전송까지 허용 시간 ( ms )
+#define SLEEP_GRACE_MS       300     // 전송 후 명령 수신을 위해 잠시 대기 ( ms )
+#define SLEEP_MSG_SLOTS      MQTT_MSG_QUEUE_SIZE
+#define SLEEP_TOPIC_LEN      32
+#define SLEEP_MSG_LEN        MQTT_MSG_KEEP_SIZE
+#define SLEEP_FMT_SLOTS      4       // 보관할 토픽별 협상 형식 수
+
+// RTC 메모리에 보관하는 상태 ( deep sleep 중에도 유지됨 )
+typedef struct Rtc_state {
+    uint32_t magic;
+    uint32_t wake_cnt;
+    bool     linked;        // 접속 정보( AP, 브로커 )가 유효한지 ( 아니면 스캔부터, 메시지/형식은 유지 )
+
+    // 접속 정보
+    char     ssid[33];
+    char     password[65];
+    uint8_t  bssid[6];
+    int32_t  channel;
+
+    // env.txt 파싱 결과
+    char     name[32];
+    char     broker_address[64];
+    int32_t  broker_port;
+    char     user_id[32];
+    char     user_password[64];
+    uint32_t interval;
+    bool     deep;
+
+    // 보관 메시지 ( 협상된 형식으로 인코딩된 그대로 )
+    uint8_t  msg_cnt;
+    char     msg_topic[SLEEP_MSG_SLOTS][SLEEP_TOPIC_LEN];
+    uint8_t  msg_fmt[SLEEP_MSG_SLOTS];
+    uint16_t msg_len[SLEEP_MSG_SLOTS];
+    uint8_t  msg[SLEEP_MSG_SLOTS][SLEEP_MSG_LEN];
+
+    // 토픽별 협상 형식 ( 다시 협상하지 않아도 같은 형식으로 전송 )
+    uint8_t  fmt_cnt;
+    char     fmt_topic[SLEEP_FMT_SLOTS][SLEEP_TOPIC_LEN];
+    uint8_t  fmt[SLEEP_FMT_SLOTS];
+
+    // wake-to-publish 측정값 ( us )
+    uint32_t last_wake_us;
+    uint32_t max_wake_us;
+} Rtc_state;
+
+RTC_DATA_ATTR Rtc_state rtc_state;
+
+class Sleep_handler {
+    private:
+        bool     isActive;      // duty-cycle 모드 사용 여부
+        bool     isFast;        // 이번 부팅이 RTC 정보로 복귀한 것인지
+        bool     isRetained;    // 타이머로 깨어났고 RTC 정보( 메시지, 형식 )가 남아있는지
+        bool     isPublished;
+        int64_t  wake_us;       // 깨어난 시각
+        uint32_t published_ms;
+
+        void save();
+        void sleep();
+        void copy(char* dst, const char* src, size_t size);
+
+        // RTC에 옮겨둔 메시지를 net에 다시 보관
+        void restore_msgs();
+
+        // RTC에 저장한 토픽별 형식을 codec에 적용
+        void restore_codec();
+
+    public:
+        Sleep_handler() = default;
+        Sleep_handler& operator=(const Sleep_handler& ref) = delete;
+        static Sleep_handler& GetInstance();
+
+        // 타이머로 깨어났고 RTC 정보가 유효한지 ( setup()에서 env.init() 대신 restore_env() 사용 )
+        bool isFastWake();
+
+        // RTC 정보로 env, 협상 형식 복원 ( JSON 파싱 없음, LittleFS는 마운트 )
+        void restore_env();
+
+        // net.init() 이후 호출: 보관 메시지 복원 및 스캔 없이 바로 연결
+        void restore_net();
+
+        // net.init() 이후 호출: 초기화 ( env.sleep 설정 확인, 정상 부팅이어도 RTC에 남은 메시지/형식은 복원 )
+        void init();
+
+        // 재부팅 전까지 절전하지 않음
+        void stay_awake() { isActive = false; }
+
+        // non-blocking 실행 ( 전송이 끝나면 절전 )
+        void run();
+};
+
+Sleep_handler& Sleep_handler::GetInstance() {
+    static Sleep_handler instance;
+
+    return instance;
+}
+
+void Sleep_handler::copy(char* dst, const char* src, size_t size) {
+    // RTC 문자열로 복원된 값이면 자기 자신이므로 복사할 필요 없음
+    if (dst == src) return;
+
+    strncpy(dst, src ? src : "", size - 1);
+    dst[size - 1] = '\0';
+}
+
+// 타이머로 깨어났고 RTC 정보가 유효한지 ( setup()에서 env.init() 대신 restore_env() 사용 )
+// 새 펌웨어 판정 대기 중이면 env.txt 부터 정상 부팅 ( Dev::Ota::boot_check() 이후에 호출 )
+bool Sleep_handler::isFastWake() {
+    wake_us    = esp_timer_get_time();
+    isRetained = rtc_state.magic == SLEEP_MAGIC && esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+    isFast     = isRetained && rtc_state.linked && !Dev::Ota::pending();
+
+    return isFast;
+}
+
+// RTC에 옮겨둔 메시지를 net에 다시 보관 ( MQTT 연결 전이므로 연결되면 전송 )
+void Sleep_handler::restore_msgs() {
+    for (uint8_t i = 0; i < rtc_state.msg_cnt; i++)
+        net.push_pending(rtc_state.msg_topic[i], rtc_state.msg_fmt[i], rtc_state.msg[i], rtc_state.msg_len[i]);
+
+    rtc_state.msg_cnt = 0;
+}
+
+// RTC에 저장한 토픽별 형식을 codec에 적용
+void Sleep_handler::restore_codec() {
+    for (uint8_t i = 0; i < rtc_state.fmt_cnt && i < SLEEP_FMT_SLOTS; i++)
+        codec.setFormat(rtc_state.fmt_topic[i], (Payload_format)rtc_state.fmt[i]);
+}
+
+// RTC 정보로 env, 협상 형식 복원 ( JSON 파싱 없음, LittleFS는 마운트 )
+void Sleep_handler::restore_env() {
+    rtc_state.wake_cnt++;
+
+    env.mount();
+
+    env.name                = rtc_state.name;
+    env.mqtt.broker_address = rtc_state.broker_address;
+    env.mqtt.broker_port    = rtc_state.broker_port;
+    env.mqtt.brokers[0]     = { rtc_state.broker_address, rtc_state.broker_port };
+    env.mqtt.broker_cnt     = 1;    // 마지막으로 접속한 브로커만 ( 실패하면 정상 부팅에서 다시 선택 )
+    env.mqtt.user_id        = rtc_state.user_id;
+    env.mqtt.user_password  = rtc_state.user_password;
+    env.sleep.interval      = rtc_state.interval;
+    env.sleep.deep          = rtc_state.deep;
+
+    restore_codec();
+
+    Dev::Log::printf("[Sleep] 빠른 복귀 #%u\n", rtc_state.wake_cnt);
+}
+
+// net.init() 이후 호출: 보관 메시지 복원 및 스캔 없이 바로 연결
+void Sleep_handler::restore_net() {
+    restore_msgs();
+
+    net.fast_connect(rtc_state.ssid, rtc_state.password, rtc_state.channel, rtc_state.bssid);
+}
+
+// 초기화 ( env.sleep 설정 확인 )
+void Sleep_handler::init() {
+    isActive    = env.sleep.interval != 0;
+    isPublished = false;
+
+    if (!isFast) {
+        // 접속 정보가 버려졌거나 판정 대기로 정상 부팅했어도, 남아있는 메시지와 형식은 살림
+        if (isRetained) {
+            restore_codec();
+            restore_msgs();
+        }
+
+        wake_us = esp_timer_get_time();
+        rtc_state.magic    = 0;
+        rtc_state.wake_cnt = 0;
+        rtc_state.last_wake_us = 0;
+        rtc_state.max_wake_us  = 0;
+    }
+
+    if (isActive) Dev::Log::printf("[Sleep] duty-cycle %us (%s)\n", env.sleep.interval, env.sleep.deep ? "deep" : "light");
+}
+
+// 다음 복귀에 필요한 정보를 RTC에 저장
+void Sleep_handler::save() {
+    copy(rtc_state.ssid,           net.getSSID().c_str(),     sizeof(rtc_state.ssid));
+    copy(rtc_state.password,       net.getPassword().c_str(), sizeof(rtc_state.password));
+    copy(rtc_state.name,           env.getName().c_str(),     sizeof(rtc_state.name));
+    copy(rtc_state.broker_address, env.mqtt.broker_address,   sizeof(rtc_state.broker_address));
+    copy(rtc_state.user_id,        env.mqtt.user_id,          sizeof(rtc_state.user_id));
+    copy(rtc_state.user_password,  env.mqtt.user_password,    sizeof(rtc_state.user_password));
+
+    rtc_state.broker_port = env.mqtt.broker_port;
+    rtc_state.interval    = env.sleep.interval;
+    rtc_state.deep        = env.sleep.deep;
+    rtc_state.channel     = WiFi.channel();
+
+    uint8_t* bssid = WiFi.BSSID();
+    if (bssid) memcpy(rtc_state.bssid, bssid, 6);
+
+    // 전송하지 못한 메시지는 RTC로 옮겨둠
+    Pending_msg msg;
+    rtc_state.msg_cnt = 0;
+
+    while (rtc_state.msg_cnt < SLEEP_MSG_SLOTS && net.pop_pending(msg)) {
+        uint8_t i = rtc_state.msg_cnt++;
+
+        copy(rtc_state.msg_topic[i], msg.topic.c_str(), SLEEP_TOPIC_LEN);
+        rtc_state.msg_fmt[i] = msg.format;
+        rtc_state.msg_len[i] = std::min(msg.body.size(), (size_t)SLEEP_MSG_LEN);
+        memcpy(rtc_state.msg[i], msg.body.data(), rtc_state.msg_len[i]);
+    }
+
+    // 협상된 형식 ( RTC 문자열에 들어가지 않는 긴 토픽은 제외 )
+    rtc_state.fmt_cnt = 0;
+
+    codec.for_each([this](const String& topic, Payload_format fmt) {
+        if (SLEEP_FMT_SLOTS <= rtc_state.fmt_cnt || SLEEP_TOPIC_LEN <= topic.length()) return;
+
+        uint8_t i = rtc_state.fmt_cnt++;
+
+        copy(rtc_state.fmt_topic[i], topic.c_str(), SLEEP_TOPIC_LEN);
+        rtc_state.fmt[i] = fmt;
+    });
+
+    rtc_state.linked = true;
+    rtc_state.magic  = SLEEP_MAGIC;
+}
+
+void Sleep_handler::sleep() {
+    Dev::Log::printf("[Sleep] %us 절전\n", env.sleep.interval);
+    Dev::Log::flush();
+
+    net.suspend();
+
+    esp_sleep_enable_timer_wakeup((uint64_t)env.sleep.interval * 1000000ULL);
+
+    if (env.sleep.deep) esp_deep_sleep_start();
+
+    // light sleep은 RAM이 유지되므로 깨어난 뒤 바로 빠른 연결 ( 설정, 협상 형식은 그대로 )
+    esp_light_sleep_start();
+
+    wake_us     = esp_timer_get_time();
+    isPublished = false;
+    rtc_state.wake_cnt++;
+
+    // 절전 전에 RTC로 옮긴 메시지를 되돌리고 연결
+    if (rtc_state.linked) {
+        restore_net();
+        return;
+    }
+
+    // 접속 정보가 버려졌으면 메시지만 되돌리고 스캔부터 다시
+    restore_msgs();
+    net.init();
+}
+
+// non-blocking 실행 ( 전송이 끝나면 절전 )
+void Sleep_handler::run() {
+    if (!isActive) return;
+
+    // 접속 후 보관 메시지까지 다 보냈으면 전송 완료로 보고 측정
+    if (!isPublished && net.isMqttConnected()) {
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - wake_us);
+        char tmp[96]; memset(tmp, '\0', 96);
+
+        rtc_state.last_wake_us = elapsed;
+        if (rtc_state.max_wake_us < elapsed) rtc_state.max_wake_us = elapsed;
+
+        sprintf(tmp, "sleep: wake #%u, wake-to-publish %ums (max %ums)",
+            rtc_state.wake_cnt, elapsed / 1000, rtc_state.max_wake_us / 1000);
+        net.publish_text("status", tmp);
+
+        isPublished  = true;
+        published_ms = millis();
+    }
+
+    // 처리중인 요청이 있거나 새 펌웨어 판정 전이면 끝날 때까지 대기
+    if (Dev::Rpc::inflight() || Dev::Ota::pending()) return;
+
+    if (isPublished && SLEEP_GRACE_MS < millis() - published_ms) {
+        save();
+        sleep();
+        return;
+    }
+
+    // 제시간에 연결하지 못했으면 접속 정보( AP, 브로커 )만 믿을 수 없으므로 버리고 절전
+    // 보관 메시지와 협상 형식은 RTC에 남겨 다음 부팅에서 되돌림
+    if (!isPublished && SLEEP_AWAKE_TIMEOUT < (uint32_t)((esp_timer_get_time() - wake_us) / 1000)) {
+        Dev::Log::println("[Sleep] 전송 시간 초과");
+
+        save();
+
+        rtc_state.linked            = false;
+        rtc_state.ssid[0]           = '\0';
+        rtc_state.password[0]       = '\0';
+        rtc_state.broker_address[0] = '\0';
+        rtc_state.broker_port       = 0;
+
+        sleep();
+    }
+}
+
+Sleep_handler& sleeper = Sleep_handler::GetInstance();
+
+#endif
@@ -0,0 +1,322 @@
+#ifndef STREAM_COMPRESSOR_H
+#define STREAM_COMPRESSOR_H
+
+/* 개요: 큰 메시지를 적은 메모리로 압축/해제하는 헤더 입니다. ( LZSS )
+ * --------------------------------------------
+ * 1. 입력을 조금씩 넣으면 압축된 결과가 sink 콜백으로 바로 흘러나갑니다 ( 전체 버퍼링 없음 )
+ * 2. 윈도우 1KB, 최대 일치 길이 66byte 로 고정되어 메모리 사용량이 일정합니다 ( 인코더 약 5KB, 디코더 약 1KB )
+ * 3. Arduino에 의존하지 않으므로 수신측(서버)에서도 그대로 include 해서 해제할 수 있습니다
+ *
+ * 압축 포맷
+ * --------------------------------------------
+ * - 플래그 1byte 뒤에 최대 8개의 항목이 따라옵니다 ( 플래그의 LSB부터 항목 순서 )
+ * - 플래그 비트 1: 리터럴 1byte
+ * - 플래그 비트 0: 일치 2byte ( 상위 10bit = 거리-1, 하위 6bit = 길이-3, 빅엔디안 )
+ *
+ * MQTT 헤더 ( Network_config.h에서 "[기기이름] " 접두사 뒤에 붙음 )
+ * --------------------------------------------
+ * - 0x1B 'Z' <버전> <원본 길이 4byte, 빅엔디안> 이후 압축 데이터
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <functional>
+
+#define LZ_WINDOW_BITS 10
+#define LZ_WINDOW      (1 << LZ_WINDOW_BITS)                   // 1024
+#define LZ_LEN_BITS    6
+#define LZ_MIN_MATCH   3
+#define LZ_MAX_MATCH   (LZ_MIN_MATCH + (1 << LZ_LEN_BITS) - 1)  // 66
+#define LZ_RING_SIZE   (LZ_WINDOW * 2)
+#define LZ_RING_MASK   (LZ_RING_SIZE - 1)
+#define LZ_HASH_BITS   9
+#define LZ_HASH_SIZE   (1 << LZ_HASH_BITS)
+#define LZ_MAX_CHAIN   16
+
+#define LZ_HEADER_MAGIC   0x1B
+#define LZ_HEADER_VERSION 0x01
+#define LZ_HEADER_SIZE    7
+
+// 압축 결과를 받아갈 함수 ( 반환형: 성공 여부, 인자: 데이터, 길이 )
+typedef std::function<bool(const uint8_t*, size_t)> LZ_sink;
+
+class LZ_Encoder {
+    private:
+        uint8_t  ring[LZ_RING_SIZE];    // 입력 원형 버퍼 ( 윈도우 + 미리보기 )
+        uint16_t head[LZ_HASH_SIZE];    // 해시별 가장 최근 위치 ( 하위 16bit )
+        uint16_t prev[LZ_WINDOW];       // 같은 해시의 이전 위치 ( 하위 16bit )
+        uint32_t cur;                   // 다음에 압축할 절대 위치
+        uint32_t end;                   // 입력된 절대 위치의 끝
+        uint32_t out_size;
+
+        uint8_t  group[1 + 8*2];        // 플래그 + 최대 8개 항목
+        uint8_t  group_len;
+        uint8_t  group_cnt;
+
+        LZ_sink  sink;
+        bool     failed;
+
+        uint16_t hash(uint32_t pos);
+        void insert(uint32_t pos);
+        void emit_literal(uint8_t c);
+        void emit_match(uint32_t dist, uint32_t len);
+        void flush_group();
+        void step();
+
+    public:
+        // 압축 시작 ( 이전 상태는 모두 초기화 )
+        void begin(LZ_sink sink);
+
+        // 입력 추가 ( 실패 시 false )
+        bool write(const uint8_t* data, size_t len);
+
+        // 남은 입력을 모두 압축해서 내보냄 ( 실패 시 false )
+        bool finish();
+
+        // 지금까지 내보낸 압축 데이터 크기
+        uint32_t size() { return out_size; }
+};
+
+class LZ_Decoder {
+    private:
+        uint8_t  window[LZ_WINDOW];
+        uint32_t pos;                   // 출력된 절대 위치
+        uint8_t  flags;
+        uint8_t  flag_cnt;              // 현재 플래그에서 남은 항목 수
+        int16_t  pending;               // 일치 항목의 첫번째 바이트 ( 없으면 -1 )
+        uint8_t  out[64];
+        uint8_t  out_len;
+
+        LZ_sink  sink;
+        bool     failed;
+
+        void put(uint8_t c);
+
+    public:
+        // 해제 시작 ( 이전 상태는 모두 초기화 )
+        void begin(LZ_sink sink);
+
+        // 압축 데이터 추가 ( 잘못된 데이터거나 sink 실패 시 false )
+        bool write(const uint8_t* data, size_t len);
+
+        // 남은 출력을 내보냄
+        bool finish();
+};
+
+/////////////////////////////////// LZ_Encoder
+
+// 압축 시작 ( 이전 상태는 모두 초기화 )
+void LZ_Encoder::begin(LZ_sink sink) {
+    memset(head, 0, sizeof(head));
+    memset(prev, 0, sizeof(prev));
+    cur = end = out_size = 0;
+    group_len = 1; group_cnt = 0; group[0] = 0;
+    this->sink = sink;
+    failed = false;
+}
+
+uint16_t LZ_Encoder::hash(uint32_t pos) {
+    uint32_t v = (ring[pos & LZ_RING_MASK] << 16) | (ring[(pos+1) & LZ_RING_MASK] << 8) | ring[(pos+2) & LZ_RING_MASK];
+
+    return (uint16_t)((v * 2654435761u) >> (32 - LZ_HASH_BITS));
+}
+
+// 위치를 해시 체인에 등록 ( 0은 비어있음을 의미하므로 위치+1 을 저장 )
+void LZ_Encoder::insert(uint32_t pos) {
+    if (end < pos + LZ_MIN_MATCH) return;
+
+    uint16_t h = hash(pos);
+
+    prev[pos & (LZ_WINDOW-1)] = head[h];
+    head[h] = (uint16_t)(pos + 1);
+}
+
+void LZ_Encoder::emit_literal(uint8_t c) {
+    group[0] |= (1 << group_cnt);
+    group[group_len++] = c;
+
+    if (++group_cnt == 8) flush_group();
+}
+
+void LZ_Encoder::emit_match(uint32_t dist, uint32_t len) {
+    uint16_t token = (uint16_t)(((dist - 1) << LZ_LEN_BITS) | (len - LZ_MIN_MATCH));
+
+    group[group_len++] = token >> 8;
+    group[group_len++] = token & 0xFF;
+
+    if (++group_cnt == 8) flush_group();
+}
+
+void LZ_Encoder::flush_group() {
+    if (group_cnt == 0) return;
+
+    if (!failed && !sink(group, group_len)) failed = true;
+
+    out_size += group_len;
+    group_len = 1; group_cnt = 0; group[0] = 0;
+}
+
+// 현재 위치에서 가장 긴 일치를 찾아 항목 1개를 내보냄
+void LZ_Encoder::step() {
+    uint32_t avail    = end - cur;
+    uint32_t best_len = 0;
+    uint32_t best_dist = 0;
+
+    if (LZ_MIN_MATCH <= avail) {
+        uint32_t max_len = (avail < LZ_MAX_MATCH) ? avail : LZ_MAX_MATCH;
+        uint16_t cand16  = head[hash(cur)];
+
+        for (int chain = 0; cand16 != 0 && chain < LZ_MAX_CHAIN; chain++) {
+            uint32_t dist = (uint16_t)((uint16_t)(cur + 1) - cand16);
+
+            // 윈도우 밖이거나 해시 테이블에 남아있던 오래된 값
+            if (dist == 0 || LZ_WINDOW < dist || cur < dist) break;
+
+            uint32_t cand = cur - dist;
+            uint32_t len  = 0;
+
+            while (len < max_len && ring[(cand + len) & LZ_RING_MASK] == ring[(cur + len) & LZ_RING_MASK]) len++;
+
+            if (best_len < len) {
+                best_len  = len;
+                best_dist = dist;
+
+                if (len == max_len) break;
+            }
+
+            cand16 = prev[cand & (LZ_WINDOW-1)];
+        }
+    }
+
+    if (best_len < LZ_MIN_MATCH) {
+        emit_literal(ring[cur & LZ_RING_MASK]);
+        insert(cur++);
+
+        return;
+    }
+
+    emit_match(best_dist, best_len);
+
+    for (uint32_t i = 0; i < best_len; i++) insert(cur++);
+}
+
+// 입력 추가 ( 실패 시 false )
+bool LZ_Encoder::write(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        // 원형 버퍼에 윈도우만큼의 과거 + 최대 일치 길이 만큼의 미리보기를 유지
+        while (LZ_MAX_MATCH <= end - cur) step();
+
+        ring[end++ & LZ_RING_MASK] = data[i];
+    }
+
+    return !failed;
+}
+
+// 남은 입력을 모두 압축해서 내보냄 ( 실패 시 false )
+bool LZ_Encoder::finish() {
+    while (cur < end) step();
+
+    flush_group();
+
+    return !failed;
+}
+
+/////////////////////////////////// LZ_Decoder
+
+// 해제 시작 ( 이전 상태는 모두 초기화 )
+void LZ_Decoder::begin(LZ_sink sink) {
+    pos = 0;
+    flags = 0; flag_cnt = 0;
+    pending = -1;
+    out_len = 0;
+    this->sink = sink;
+    failed = false;
+}
+
+void LZ_Decoder::put(uint8_t c) {
+    window[pos++ & (LZ_WINDOW-1)] = c;
+    out[out_len++] = c;
+
+    if (out_len == sizeof(out)) {
+        if (!failed && !sink(out, out_len)) failed = true;
+        out_len = 0;
+    }
+}
+
+// 압축 데이터 추가 ( 잘못된 데이터거나 sink 실패 시 false )
+bool LZ_Decoder::write(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len && !failed; i++) {
+        uint8_t c = data[i];
+
+        if (pending < 0 && flag_cnt == 0) {
+            flags = c;
+            flag_cnt = 8;
+            continue;
+        }
+
+        if (pending < 0 && (flags & 1)) {
+            put(c);
+        } else if (pending < 0) {
+            pending = c;
+            continue;
+        } else {
+            uint16_t token = (uint16_t)((pending << 8) | c);
+            uint32_t dist  = (token >> LZ_LEN_BITS) + 1;
+            uint32_t n     = (token & ((1 << LZ_LEN_BITS) - 1)) + LZ_MIN_MATCH;
+
+            pending = -1;
+
+            if (pos < dist) {
+                failed = true;
+                break;
+            }
+
+            for (uint32_t k = 0; k < n; k++) put(window[(pos - dist) & (LZ_WINDOW-1)]);
+        }
+
+        flags >>= 1;
+        flag_cnt--;
+    }
+
+    return !failed;
+}
+
+// 남은 출력을 내보냄
+bool LZ_Decoder::finish() {
+    if (!failed && out_len && !sink(out, out_len)) failed = true;
+
+    out_len = 0;
+
+    return !failed && pending < 0;
+}
+
+// Device_config.h 의 압축 정책 ( 인코더는 처음 압축할 때 생성 )
+struct Zip_on {
+    static constexpr bool enabled = true;
+
+    static LZ_Encoder& encoder() {
+        static LZ_Encoder instance;
+
+        return instance;
+    }
+
+    // 압축 결과 크기만 계산 ( 헤더 제외 )
+    static size_t measure(const uint8_t* src, size_t len) {
+        encoder().begin([](const uint8_t*, size_t) { return true; });
+        encoder().write(src, len);
+        encoder().finish();
+
+        return encoder().size();
+    }
+
+    // 압축 결과를 sink 로 흘려보냄 ( 실패 시 false )
+    static bool stream(const uint8_t* src, size_t len, LZ_sink sink) {
+        encoder().begin(sink);
+        encoder().write(src, len);
+
+        return encoder().finish();
+    }
+};
+
+#endif
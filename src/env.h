@@ -5,22 +5,56 @@
  * --------------------------------------------
  * 1. LittleFS를 사용합니다.
  * 2. ArduJson을 사용하여 파싱 후 관리합니다.
+ * 3. 로그에는 비밀번호를 출력하지 않습니다 ( 설정 여부만 표시 )
+ * 4. 펌웨어는 전역 env 하나를 쓰고, 호스트 시뮬레이터는 기기마다 EnvData를 만들어 parse()로 채웁니다
 */
 
 #include <ArduinoJson.h>
 #include <Arduino.h>
 #include <FS.h>
 #include <LittleFS.h>
+#include <Log_config.h>
 #define FOR(i, b, e) for(int i = b; i < e; i++)
 
+#define ENV_MAX_BROKER 4
+#define ENV_MAX_METRIC 6
+
+// 브로커 서버 주소 1개
+typedef struct MQTT_endpoint {
+    const char* address;
+    int port;
+} MQTT_endpoint;
+
 // 브로커 서버관련 정보
 typedef struct MQTT_info {
     const char* broker_address;
     int broker_port;
     const char* user_id;
     const char* user_password;  // 암호화 여부
+    MQTT_endpoint brokers[ENV_MAX_BROKER];  // 후보 브로커 ( 적은 순서가 우선순위 )
+    uint8_t broker_cnt;
 } MQTT_info;
 
+// 절전(duty-cycle) 관련 정보 ( interval이 0이면 항상 켜짐 )
+typedef struct Sleep_info {
+    uint32_t interval;  // 보고 주기 ( 초 )
+    bool deep;          // true: deep sleep, false: light sleep
+} Sleep_info;
+
+// 집계할 측정값 1개 ( window: 윈도우 길이 초, slices: 1이면 텀블링 )
+typedef struct Metric_info {
+    const char* name;
+    uint32_t window;
+    uint8_t slices;
+} Metric_info;
+
+// 집계 관련 정보 ( 적지 않은 측정값은 수집하지 않음 )
+typedef struct Agg_info {
+    Metric_info metrics[ENV_MAX_METRIC];
+    uint8_t metric_cnt;
+    bool raw_sample;    // 샘플 블록 원본도 전송할지 ( 기본은 요약만 )
+} Agg_info;
+
 class EnvData {
     private:
         JsonDocument raw;
@@ -32,15 +66,27 @@ class EnvData {
         JsonObject wifi_list;
         String name;
         MQTT_info mqtt;
+        Sleep_info sleep;
+        Agg_info agg;
         
         EnvData& operator=(const EnvData& ref) = delete;  
         static EnvData& GetInstance();
         void init();
+        
+        // env.txt 내용 파싱 ( 실패 시 false, 시뮬레이터는 파일 없이 이것만 사용 )
+        bool parse(const String& content);
+        
+        // LittleFS 마운트 ( 실패하면 성공할 때까지 재시도, env.txt를 읽지 않는 절전 복귀에서도 사용 )
+        void mount();
+        
         void print_wifi_list();
         void print_mqtt();
         String fileLoad();
         String getName();
         
+        // 로그 출력용 비밀번호 ( 설정 여부만 )
+        static const char* mask(const char* password) { return (password && *password) ? "****" : "(없음)"; }
+        
 };
 
 EnvData& EnvData::GetInstance() {
@@ -49,23 +95,29 @@ EnvData& EnvData::GetInstance() {
     return instance;
 }
 
-String EnvData::fileLoad() {           
+// LittleFS 마운트 ( 이미 마운트 되어 있으면 바로 반환 )
+void EnvData::mount() {
     while (!LittleFS.begin(true)) {
-        Serial.println("An Error has occurred while mounting LittleFS");
+        Dev_log::println("An Error has occurred while mounting LittleFS");
         delay(500);
     }
+}
+
+String EnvData::fileLoad() {           
+    mount();
     
     File file = LittleFS.open("/env.txt");
     String content = "";
     
     if(!file) {
-        Serial.println("Failed to open file for reading");
+        Dev_log::println("Failed to open file for reading");
         return String();
     }
 
     if(file.available()) content = file.readString();
     
-    Serial.printf("content: %s\n", content.c_str());
+    // 비밀번호가 들어있으므로 내용은 출력하지 않음
+    Dev_log::printf("env.txt: %u byte\n", content.length());
     
     file.close();
     
@@ -74,16 +126,24 @@ String EnvData::fileLoad() {
 }
 
 void EnvData::init() {
-    name = "NULL";
+    // 파일에서 읽은 데이터를 가지고 env객체 초기화
+    if (!parse(fileLoad())) return;
     
-    String load_data = fileLoad();
+    // 정리한 내용 출력
+    print_wifi_list();
+    print_mqtt();
+}
+
+// env.txt 내용 파싱 ( 실패 시 false, 시뮬레이터는 파일 없이 이것만 사용 )
+bool EnvData::parse(const String& content) {
+    name = "NULL";
     
-    DeserializationError err = deserializeJson(raw, load_data);
+    DeserializationError err = deserializeJson(raw, content);
     
     if (err) {
-        Serial.print(F("deserializeJson() failed: "));
-        Serial.println(err.f_str());
-        return;
+        Dev_log::print(F("deserializeJson() failed: "));
+        Dev_log::println(err.f_str());
+        return false;
     }
     
     wifi_list = raw["wifi"].as<JsonObject>();
@@ -94,10 +154,34 @@ void EnvData::init() {
     mqtt.broker_port    = raw["mqtt"]["port"];
     mqtt.user_id        = raw["mqtt"]["user_id"];
     mqtt.user_password  = raw["mqtt"]["user_password"];
+    mqtt.broker_cnt     = 0;
     
-    // 정리한 내용 출력
-    print_wifi_list();
-    print_mqtt();
+    // 후보 브로커 목록 ( 없으면 broker_address 하나만 사용 )
+    for (JsonObject broker : raw["mqtt"]["brokers"].as<JsonArray>()) {
+        if (ENV_MAX_BROKER <= mqtt.broker_cnt) break;
+        
+        mqtt.brokers[mqtt.broker_cnt++] = { broker["address"], broker["port"] | mqtt.broker_port };
+    }
+    
+    if (mqtt.broker_cnt == 0 && mqtt.broker_address) 
+        mqtt.brokers[mqtt.broker_cnt++] = { mqtt.broker_address, mqtt.broker_port };
+    
+    sleep.interval = raw["sleep"]["interval"] | 0;
+    sleep.deep     = raw["sleep"]["mode"] != "light";
+    
+    // 집계 측정값 ( ex: "agg": {"metrics": {"rssi": [60], "heap": [300, 5], "ch0": [10]}, "raw_sample": false} )
+    agg.metric_cnt = 0;
+    agg.raw_sample = raw["agg"]["raw_sample"] | false;
+    
+    for (JsonPair pair : raw["agg"]["metrics"].as<JsonObject>()) {
+        if (ENV_MAX_METRIC <= agg.metric_cnt) break;
+        
+        JsonArray opt = pair.value().as<JsonArray>();
+        
+        agg.metrics[agg.metric_cnt++] = { pair.key().c_str(), opt[0] | 60u, opt[1] | (uint8_t)1 };
+    }
+    
+    return true;
 }
 
 void EnvData::print_wifi_list() {
@@ -105,23 +189,25 @@ void EnvData::print_wifi_list() {
         const char* ssid     = pair.key().c_str();
         const char* password = pair.value().as<JsonArray>()[0];
         
-        Serial.print("SSID: ");
-        Serial.print(ssid);
-        Serial.print(", Password: ");
-        Serial.println(password);
+        Dev_log::print("SSID: ");
+        Dev_log::print(ssid);
+        Dev_log::print(", Password: ");
+        Dev_log::println(mask(password));
     }
 
 }
 
 void EnvData::print_mqtt() {
-    Serial.print("Broker Address: ");
-    Serial.println(mqtt.broker_address);
-    Serial.print("Port: ");
-    Serial.println(mqtt.broker_port);
-    Serial.print("User ID: ");
-    Serial.println(mqtt.user_id);
-    Serial.print("User Password: ");
-    Serial.println(mqtt.user_password);
+    FOR(i, 0, mqtt.broker_cnt) {
+        Dev_log::print("Broker Address: ");
+        Dev_log::print(mqtt.brokers[i].address);
+        Dev_log::print(", Port: ");
+        Dev_log::println(mqtt.brokers[i].port);
+    }
+    Dev_log::print("User ID: ");
+    Dev_log::println(mqtt.user_id);
+    Dev_log::print("User Password: ");
+    Dev_log::println(mask(mqtt.user_password));
 }
 
 String EnvData::getName() {
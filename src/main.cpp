@@ -5,6 +5,8 @@
 #include <env.h>
 #include <HW_config.h>
 #include <Network_config.h>
+#include <Rpc_handler.h>
+#include <Sleep_handler.h>
 #define FOR(i, b, e) for(int i = b; i < e; i++)
 
 // 1. 네트워크 연결 되면 5초마다 2번 빠르게 점멸
@@ -13,15 +15,146 @@
 // 4. 주변에 와이파이가 없을 경우 LED 빠르게 점멸
 // 5. 저장되있는 비밀번호로 5초 이상 연결 시도에도 무반응 시 연결 차단
 // 6. 연결 상태에서 갑작스러운 연결 해제 시 감지 가능
-// 7. LittleFS저장소를 FTP를 통해 접근 및 수정 가능
-// 8. LED점멸기능을 뺴고 싶을 경우 HW_config.h에서 단순히 헤더 참조 빼면 됨
+// 7. LittleFS저장소를 MQTT 파일 전송으로 접근 및 수정 가능 ( File_transfer.h 참고, FTP는 DEVICE_FULL 구성에서만 )
+// 8. status 메시지는 "fmt <topic> msgpack" 명령으로 MessagePack 형식 전송 가능 ( Payload_codec.h 참고 )
+// 9. "fmt <topic> zip" 으로 협상한 토픽은 MQTT_MSG_CHUNK_SIZE 보다 큰 메시지를 압축해서 전송 ( Stream_compressor.h 참고, 기본은 압축 안 함 )
+// 10. 펌웨어 업데이트는 MQTT로 가능 ( OTA_handler.h 참고, 실패 시 자동 롤백 )
+// 11. rpc/<이름>/req 로 id가 붙은 요청을 여러개 동시에 보낼 수 있음 ( Rpc_handler.h 참고 )
+// 12. Dev::Sample에 등록한 센서는 전용 태스크가 읽고, 채널 값은 "ch<번호>" 측정값으로 집계 ( Sampler.h 참고, DEVICE_FULL 구성 )
+//     기본 채널은 ch0 = SAMPLE_ADC_PIN 전압(mV), SAMPLE_PERIOD_MS 마다 ( HW_config.h, 센서를 더 달면 setup()에서 add_channel )
+//     블록 원본은 env.txt "agg"의 "raw_sample"이 true일 때만 "sample" 토픽으로 전송
+// 13. env.txt "agg"의 "metrics"에 적은 측정값( rssi, heap, ch0~ch3 )만 윈도우 단위 요약을 "agg" 토픽으로 전송 ( 기본은 없음 )
+//     원본은 "raw <이름>" 명령으로 요청 ( Aggregator.h 참고 )
+// 14. "stats" 명령(또는 RPC stats)으로 접속/전송 횟수와 지연시간 확인 가능, "brokers" 명령으로 브로커별 RTT 확인
+// 15. env.txt에 "sleep" 설정이 있으면 보고 후 절전, 깨어나면 스캔 없이 바로 연결 ( Sleep_handler.h 참고, "awake" 명령으로 해제 )
+// 16. LED점멸기능을 뺴고 싶을 경우 Device_config.h에서 LED_off 정책으로 조립하면 됨 ( 구성별 크기는 빌드 시 출력 )
+// 17. 파일 전송, OTA, RPC, 샘플러, 집계, 압축도 같은 방식으로 _off 정책으로 뺄 수 있음 ( 빠진 모듈은 메모리를 쓰지 않음 )
+
+#define METRIC_CH_CNT 4     // 집계할 수 있는 샘플러 채널 수 ( ch0 ~ ch3 )
+
+SimpleTimer metricTimer;
+int metric_rssi = -1;
+int metric_heap = -1;
+int metric_ch[METRIC_CH_CNT] = { -1, -1, -1, -1 };
+
+/////////////////////////////////// RPC 메소드
+
+// 사용중인 저장소 용량 ( result: total, used )
+int rpc_lfs(Rpc_call& call, JsonObject result) {
+    result["total"] = LittleFS.totalBytes();
+    result["used"]  = LittleFS.usedBytes();
+
+    return RPC_OK;
+}
+
+// 현재 접속된 WiFi ( result: ssid, rssi, ip )
+int rpc_net(Rpc_call& call, JsonObject result) {
+    result["ssid"] = WiFi.SSID();
+    result["rssi"] = WiFi.RSSI();
+    result["ip"]   = WiFi.localIP().toString();
+
+    return RPC_OK;
+}
+
+// 주변 WiFi 스캔 ( 스캔이 끝날 때 까지 대기, result: networks [{ssid, rssi, secured}] )
+// 스캔 결과 출력/전송( Scan_report ) 구성과 상관없이 동작
+int rpc_scan(Rpc_call& call, JsonObject result) {
+    uint32_t seq = net.getScanSeq();
+
+    WiFi.scanNetworks(true);
+
+    call.poll = [seq](Rpc_call& self, JsonObject res) {
+        if (net.getScanSeq() == seq) return (int)RPC_PENDING;
+
+        JsonArray networks = res["networks"].to<JsonArray>();
+
+        FOR(i, 0, net.getScanCount()) {
+            const Wifi_info& info = net.getScanResult(i);
+            JsonObject item = networks.add<JsonObject>();
+
+            item["ssid"]    = info.ssid;
+            item["rssi"]    = info.RSSI;
+            item["secured"] = info.Encryption.length() != 0;
+        }
+
+        return (int)RPC_OK;
+    };
+
+    return RPC_PENDING;
+}
+
+// 접속/전송 통계 ( result: Network_Handler::getStats() 참고 )
+int rpc_stats(Rpc_call& call, JsonObject result) {
+    JsonDocument doc;
+
+    deserializeJson(doc, net.getStats());
+
+    for (JsonPair pair : doc.as<JsonObject>()) result[pair.key()] = pair.value();
+
+    return RPC_OK;
+}
+
+// 토픽 별 인코딩 형식 협상 ( params: topic, format )
+int rpc_fmt(Rpc_call& call, JsonObject result) {
+    if (!call.params["topic"].is<const char*>() || !call.params["format"].is<const char*>())
+        return RPC_ERR_PARAMS;
+
+    String cmd = "fmt " + call.params["topic"].as<String>() + " " + call.params["format"].as<String>();
+
+    codec.negotiate(cmd);
+    result["format"] = Payload_codec::formatName(codec.getFormat(call.params["topic"].as<String>()));
+
+    return RPC_OK;
+}
 
 void setup() {
-    Serial.begin(115200); // 시리얼 통신 초기화
+    Dev::Log::begin(115200); // 시리얼 통신 초기화
+    Dev::Ota::boot_check();  // 새 이미지면 부팅 횟수 확인 ( 다른 초기화보다 먼저 )
 
     hw_init();
-    env.init();
-    net.init();
+    Dev::init();
+    codec.init(Dev::Zip::enabled);  // 절전 복귀 시 restore_env()가 협상 형식을 다시 적용하므로 먼저
+
+    // 샘플러 채널 등록 후 시작 ( Dev::init() 이 채널을 비우므로 그 뒤에, 샘플러가 빠진 구성에서는 아무것도 안 함 )
+    Dev::Sample::add_adc(SAMPLE_ADC_PIN);
+    Dev::Sample::begin(SAMPLE_PERIOD_MS);
+
+    // 절전에서 깨어났으면 env.txt 파싱과 WiFi 스캔 생략
+    if (sleeper.isFastWake()) {
+        sleeper.restore_env();
+        net.init(false);
+        sleeper.restore_net();
+    } else {
+        env.init();
+        net.init();
+    }
+    sleeper.init();
+
+    Dev::Rpc::reg_method("lfs",  rpc_lfs);
+    Dev::Rpc::reg_method("net",  rpc_net);
+    Dev::Rpc::reg_method("scan", rpc_scan);
+    Dev::Rpc::reg_method("fmt",  rpc_fmt);
+    Dev::Rpc::reg_method("stats", rpc_stats);
+
+    // env.txt에 적은 측정값만 등록 ( rssi, heap은 1초마다 측정, chN은 샘플러 블록마다 )
+    Dev::Agg::init([](JsonDocument& doc, String text) { net.publish("agg", doc, text); });
+    FOR(i, 0, env.agg.metric_cnt) {
+        const Metric_info& info = env.agg.metrics[i];
+        String name = info.name;
+        int id = Dev::Agg::reg_metric(name, info.window * 1000, info.slices);
+        
+        if (id < 0) {
+            Dev::Log::printf("[Agg] %s 등록 실패\n", info.name);
+            continue;
+        }
+        
+        if (name == "rssi") metric_rssi = id;
+        else if (name == "heap") metric_heap = id;
+        else FOR(ch, 0, METRIC_CH_CNT) if (name == "ch" + String(ch)) metric_ch[ch] = id;
+    }
+    metricTimer.setInterval(1000);
+    
+    Dev::Log::printf("[Device] %s 구성, 부팅 %lu ms\n", DEVICE_NAME, millis());
 }
 
 void loop() {   
@@ -34,7 +167,13 @@ void loop() {
 
             sprintf(msg, "Total: %dbyte\nUsed: %dbyte", LittleFS.totalBytes(), LittleFS.usedBytes());
             
-            net.publish("status", msg);
+            JsonDocument doc;
+            JsonArray arr = doc.to<JsonArray>();
+            arr.add(SCHEMA_LFS);
+            arr.add(LittleFS.totalBytes());
+            arr.add(LittleFS.usedBytes());
+            
+            net.publish("status", doc, msg);
 
             return;
         }
@@ -48,13 +187,81 @@ void loop() {
                 WiFi.localIP().toString().c_str()
             );
 
-            net.publish("status", tmp);
+            JsonDocument doc;
+            JsonArray arr = doc.to<JsonArray>();
+            arr.add(SCHEMA_NET);
+            arr.add(WiFi.SSID());
+            arr.add(WiFi.RSSI());
+            arr.add((uint32_t)WiFi.localIP());
+
+            net.publish("status", doc, tmp);
             
             // 비동기 스캔 시작
             WiFi.scanNetworks(true);
 
             return;
         }
+        // 토픽 별 인코딩 형식 협상 ( ex: fmt status msgpack )
+        if (codec.negotiate(recv)) {
+            return;
+        }
+        // 인코딩 비용 및 크기 측정값 확인
+        if (recv == "codec") {
+            net.publish_text("status", codec.stats());
+            
+            return;
+        }
+        // 대표적인 큰 메시지로 압축률 및 압축 비용 측정
+        if (recv == "zbench") {
+            String scan_log = net.getLastScan();
+            String env_txt;
+            File file = LittleFS.open("/env.txt");
+            
+            if (file) {
+                env_txt = file.readString();
+                file.close();
+            }
+            
+            String result = net.compress_bench("scan", &scan_log);
+            result += net.compress_bench("env.txt", &env_txt);
+            
+            net.publish_text("status", result);
+            
+            return;
+        }
+        // 센서 샘플링 처리량 및 지터 확인
+        if (recv == "sampler") {
+            net.publish_text("status", Dev::Sample::stats());
+            
+            return;
+        }
+        // 접속/전송 통계 확인
+        if (recv == "stats") {
+            net.publish_text("status", net.getStats());
+            
+            return;
+        }
+        // 브로커별 RTT 및 실패 횟수 확인
+        if (recv == "brokers") {
+            net.publish_text("status", net.getBrokerStats());
+            
+            return;
+        }
+        // 최근 원본 측정값 요청 ( ex: raw rssi )
+        if (recv.startsWith("raw ")) {
+            String raw = Dev::Agg::raw(recv.substring(4));
+            
+            net.publish_text("status", raw.length() ? raw : "unknown metric");
+            
+            return;
+        }
+        // 재부팅 전까지 절전하지 않음 ( 유지보수용 )
+        if (recv == "awake") {
+            sleeper.stay_awake();
+            net.publish_text("status", "sleep disabled until reboot");
+            
+            return;
+        }
         // 재부팅 지시
         if (recv == "reboot") {
             ESP.restart();
@@ -63,8 +270,22 @@ void loop() {
         }
     }
     
+    // 다 찬 샘플 블록은 채널 값을 집계에 넣고, 설정된 경우에만 원본을 복사 없이 그대로 전송 후 반환
+    Dev::Sample::run(
+        [](uint8_t ch, float v) { if (ch < METRIC_CH_CNT) Dev::Agg::add(metric_ch[ch], v); },
+        [](const uint8_t* buf, size_t len) { if (env.agg.raw_sample) net.publish("sample", buf, len); }
+    );
+    
+    if (metricTimer.isReady()) {
+        if (metric_rssi >= 0 && WiFi.isConnected()) Dev::Agg::add(metric_rssi, WiFi.RSSI());
+        if (metric_heap >= 0) Dev::Agg::add(metric_heap, ESP.getFreeHeap());
+        
+        metricTimer.reset();
+    }
+    Dev::Agg::run(millis());
+    
     net.run();
-    #ifdef LED_HANDLER_H
-    led.run();
-    #endif
+    Dev::Rpc::run();
+    sleeper.run();
+    Dev::run();
 }
\ No newline at end of file
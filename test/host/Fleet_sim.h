@@ -0,0 +1,269 @@
+#ifndef FLEET_SIM_H
+#define FLEET_SIM_H
+
+/* 개요: 펌웨어의 EnvData / Network_Handler 를 기기마다 하나씩 만들어 한 프로세스에서 돌리는 시뮬레이터 입니다.
+ * --------------------------------------------
+ * 1. DEVICE_SIM 구성으로 src 의 헤더를 그대로 include 합니다 ( Arduino API는 test/host/arduino 대역 )
+ * 2. Sim_device 는 main.cpp 의 setup()/loop() 중 네트워크 부분만 따라합니다
+ *    - setup(): env.txt 파싱 → net.init() ( 스캔 → AP 접속 → MQTT 접속 → wake-up! 전송 )
+ *    - loop() : report_ms 마다 status 보고( 앱 텔레메트리 대신 ), net.run()
+ * 3. Sim_fleet 은 세계 시각을 SIM_LOOP_MS 씩 진행하며, 시각이 된 기기의 loop()를 한번씩 실행합니다
+ *    - 접속처럼 막히는 호출로 기기 시각이 앞서간 기기는 세계 시각이 따라잡을 때까지 쉼
+ * 4. mark() 이후의 브로커 측정값과 기기별 복구 시간을 Sim_report 로 모읍니다
+*/
+
+#include <Network_config.h>
+#include <Sim_world.h>
+#include <memory>
+
+#define SIM_LOOP_MS  20     // 기기 loop() 한번에 걸리는 시간
+#ifndef SIM_PER_AP
+#define SIM_PER_AP   50     // AP 1개에 붙는 기기 수
+#endif
+
+// 기기 1대
+class Sim_device {
+    private:
+        String      env_txt;
+        uint32_t    report_ms;
+        SimpleTimer reportTimer;
+        bool        booted;
+
+    public:
+        Sim_node        node;
+        EnvData         env;
+        Network_Handler net;
+        uint32_t        recovered_ms;   // mark() 이후 처음 MQTT 접속된 시각 ( 0이면 아직 )
+
+        Sim_device(uint32_t id, String env_txt, uint32_t boot_ms, uint32_t report_ms)
+            : env_txt(env_txt), report_ms(report_ms), booted(false), node(), net(env), recovered_ms(0) {
+            node.id = id;
+            node.t  = boot_ms;
+            node.ap = -1;
+        }
+
+        // 부팅 전이면 setup(), 이후엔 loop() ( 기기 시각이 된 경우만 호출됨 )
+        void step() {
+            if (!booted) {
+                env.parse(env_txt);
+                net.init();
+
+                reportTimer.setInterval(report_ms);
+                reportTimer.reset();
+                booted = true;
+
+                return;
+            }
+
+            if (report_ms && reportTimer.isReady()) {
+                net.publish("status", "report from " + env.getName());
+                reportTimer.reset();
+            }
+
+            net.run();
+        }
+
+        // env.txt 의 AP가 인증 실패로 차단됐는지
+        bool banned() {
+            for (JsonPair pair : env.wifi_list)
+                if (pair.value()[(int)EnvData::STATUS] == AUTH_WRONG) return true;
+
+            return false;
+        }
+};
+
+// mark() 이후의 측정 결과
+typedef struct Sim_report {
+    uint32_t devices;
+    uint32_t attempts;          // MQTT 접속 시도
+    uint32_t accepted;
+    uint32_t refused;
+    uint32_t timeouts;
+    uint32_t peak_attempts;     // 초당 최대
+    uint32_t peak_accepted;
+    uint32_t msgs;
+    uint32_t bytes;
+    uint32_t peak_msgs;
+    uint32_t connect_p50;       // 성공한 접속의 지연시간 ( ms )
+    uint32_t connect_p99;
+    uint32_t connect_max;
+    uint32_t recovered;         // 다시 접속한 기기 수
+    uint32_t recover_p50;       // mark() 부터 다시 접속할 때까지 ( ms )
+    uint32_t recover_p90;
+    uint32_t recover_max;
+    uint32_t pending_flushed;   // 재접속 시 전송된 보관 메시지
+    uint32_t dropped;
+    uint32_t banned;            // AP를 인증 실패로 차단한 기기 수
+} Sim_report;
+
+class Sim_fleet {
+    private:
+        std::vector<std::unique_ptr<Sim_device>> devs;
+        uint32_t mark_ms;
+        size_t   mark_connects;     // mark() 시점의 broker.connect_ms 개수
+        uint32_t report_ms;
+
+        Sim_world& world() { return Sim_world::GetInstance(); }
+
+        String env_for(uint32_t id) {
+            char tmp[256];
+            int  ap = id / SIM_PER_AP;
+
+            snprintf(tmp, sizeof(tmp),
+                "{\"name\":\"sim-%u\",\"wifi\":{\"ap-%d\":[\"pw-%d\",0]},"
+                "\"mqtt\":{\"broker_address\":\"127.0.0.1\",\"port\":1883,\"user_id\":\"sim\",\"user_password\":\"sim\"}}",
+                id, ap, ap);
+
+            return tmp;
+        }
+
+        static uint32_t pct(std::vector<uint32_t>& v, float q) {
+            if (v.empty()) return 0;
+
+            std::sort(v.begin(), v.end());
+
+            return v[(size_t)(q * (v.size() - 1))];
+        }
+
+    public:
+        // 세계를 비우고 기기 n대 생성 ( SIM_PER_AP 대마다 AP 1개, 0 ~ boot_spread_ms 사이에 부팅 )
+        // accept_rate: 브로커가 초당 처리하는 접속 수, report_ms: 기기별 보고 주기 ( 0이면 보고 안함 )
+        void init(uint32_t n, uint32_t accept_rate, uint32_t rtt_ms, uint32_t boot_spread_ms, uint32_t report_ms) {
+            // 기기가 먼저 사라져야 브로커 세션 수가 맞음
+            devs.clear();
+            world().reset(accept_rate, rtt_ms);
+            codec.init(false);
+
+            this->report_ms = report_ms;
+
+            for (uint32_t i = 0; i < (n + SIM_PER_AP - 1) / SIM_PER_AP; i++) {
+                char ssid[16], pw[16];
+
+                snprintf(ssid, sizeof(ssid), "ap-%u", i);
+                snprintf(pw, sizeof(pw), "pw-%u", i);
+                world().aps.push_back({ ssid, pw, -40 - (int32_t)(i % 40), 1 + (int32_t)(i % 11), true, 0 });
+            }
+
+            for (uint32_t i = 0; i < n; i++)
+                devs.emplace_back(new Sim_device(i, env_for(i), world().now + world().random(0, boot_spread_ms + 1), report_ms));
+
+            mark();
+        }
+
+        // 모든 기기를 동시에 재부팅 ( 0 ~ spread_ms 사이에 다시 부팅 )
+        void reboot_all(uint32_t spread_ms) {
+            for (auto& dev : devs) {
+                uint32_t id = dev->node.id;
+
+                dev.reset();
+                dev.reset(new Sim_device(id, env_for(id), world().now + world().random(0, spread_ms + 1), report_ms));
+            }
+        }
+
+        // 측정 시작 시점
+        void mark() {
+            mark_ms       = world().now;
+            mark_connects = world().broker.connect_ms.size();
+
+            for (auto& dev : devs) dev->recovered_ms = 0;
+        }
+
+        void run_for(uint32_t ms) {
+            uint32_t end = world().now + ms;
+
+            while (world().now < end) {
+                world().now += SIM_LOOP_MS;
+
+                for (auto& dev : devs) {
+                    Sim_node& node = dev->node;
+
+                    world().cur = &node;
+
+                    while (node.t <= world().now) {
+                        dev->step();
+                        node.t += SIM_LOOP_MS;
+                    }
+
+                    if (!dev->recovered_ms && dev->net.isMqttConnected()) dev->recovered_ms = node.t;
+                }
+
+                world().cur = nullptr;
+            }
+        }
+
+        uint32_t connected() {
+            uint32_t cnt = 0;
+
+            for (auto& dev : devs) cnt += dev->net.isMqttConnected();
+
+            return cnt;
+        }
+
+        Sim_report report() {
+            Sim_report r;
+            Sim_broker& broker = world().broker;
+
+            memset(&r, 0, sizeof(r));
+            r.devices = devs.size();
+
+            for (size_t s = mark_ms / 1000; s < broker.seconds.size(); s++) {
+                const Sim_second& sec = broker.seconds[s];
+
+                r.attempts += sec.attempts;
+                r.accepted += sec.accepted;
+                r.refused  += sec.refused;
+                r.timeouts += sec.timeouts;
+                r.msgs     += sec.msgs;
+                r.bytes    += sec.bytes;
+                r.peak_attempts = std::max(r.peak_attempts, sec.attempts);
+                r.peak_accepted = std::max(r.peak_accepted, sec.accepted);
+                r.peak_msgs     = std::max(r.peak_msgs, sec.msgs);
+            }
+
+            std::vector<uint32_t> connect(broker.connect_ms.begin() + mark_connects, broker.connect_ms.end());
+            std::vector<uint32_t> recover;
+
+            for (auto& dev : devs) {
+                const Net_stats& stats = dev->net.getNetStats();
+
+                if (dev->recovered_ms) recover.push_back(dev->recovered_ms - mark_ms);
+
+                r.pending_flushed += stats.pending_flushed;
+                r.dropped         += stats.dropped;
+                r.banned          += dev->banned();
+            }
+
+            r.connect_p50 = pct(connect, 0.50f);
+            r.connect_p99 = pct(connect, 0.99f);
+            r.connect_max = pct(connect, 1.0f);
+            r.recovered   = recover.size();
+            r.recover_p50 = pct(recover, 0.50f);
+            r.recover_p90 = pct(recover, 0.90f);
+            r.recover_max = pct(recover, 1.0f);
+
+            return r;
+        }
+
+        // 출력용 문자열
+        static std::string format(const char* name, const Sim_report& r) {
+            char tmp[768];
+
+            snprintf(tmp, sizeof(tmp),
+                "[%s] devices %u\n"
+                "  mqtt connect: %u attempts (peak %u/s), %u accepted (peak %u/s), %u refused, %u timeouts\n"
+                "  connect latency(ms): p50 %u, p99 %u, max %u\n"
+                "  recovery(ms): %u/%u devices, p50 %u, p90 %u, max %u\n"
+                "  publish: %u msgs (peak %u/s), %u bytes, pending flushed %u, dropped %u\n"
+                "  wifi banned by timeout: %u",
+                name, r.devices,
+                r.attempts, r.peak_attempts, r.accepted, r.peak_accepted, r.refused, r.timeouts,
+                r.connect_p50, r.connect_p99, r.connect_max,
+                r.recovered, r.devices, r.recover_p50, r.recover_p90, r.recover_max,
+                r.msgs, r.peak_msgs, r.bytes, r.pending_flushed, r.dropped,
+                r.banned);
+
+            return tmp;
+        }
+};
+
+#endif
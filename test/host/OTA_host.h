@@ -0,0 +1,218 @@
+#ifndef OTA_HOST_H
+#define OTA_HOST_H
+
+/* 개요: 호스트(Linux)에서 OTA_core.h 를 돌리기 위한 구현 입니다.
+ * --------------------------------------------
+ * 1. OTA_file_flash    : 파티션 이미지 파일에 기록 ( 섹터 지우기는 0xFF 로 채움 )
+ * 2. OTA_host_platform : 상태 파일은 메모리에 보관하고, 시간은 테스트가 직접 움직입니다
+ *    - restart() 는 횟수만 세고 돌아옵니다 ( 재부팅은 OTA_core 를 새로 만들어 흉내냄 )
+ * 3. SHA-256 은 mbedtls 대신 작은 구현(Host_sha256)을 사용합니다
+*/
+
+#include <OTA_core.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// SHA-256 ( FIPS 180-4 )
+class Host_sha256 {
+    private:
+        uint32_t h[8];
+        uint8_t  block[64];
+        size_t   block_len;
+        uint64_t total;
+
+        static uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+        void compress() {
+            static const uint32_t k[64] = {
+                0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+            };
+            uint32_t w[64];
+
+            for (int i = 0; i < 16; i++)
+                w[i] = ((uint32_t)block[i*4] << 24) | ((uint32_t)block[i*4+1] << 16) | ((uint32_t)block[i*4+2] << 8) | block[i*4+3];
+
+            for (int i = 16; i < 64; i++) {
+                uint32_t s0 = rotr(w[i-15], 7) ^ rotr(w[i-15], 18) ^ (w[i-15] >> 3);
+                uint32_t s1 = rotr(w[i-2], 17) ^ rotr(w[i-2], 19) ^ (w[i-2] >> 10);
+                w[i] = w[i-16] + s0 + w[i-7] + s1;
+            }
+
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+
+            for (int i = 0; i < 64; i++) {
+                uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+
+                hh = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+        }
+
+    public:
+        void begin() {
+            static const uint32_t init[8] = {
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+            };
+
+            memcpy(h, init, sizeof(h));
+            block_len = 0;
+            total     = 0;
+        }
+
+        void update(const uint8_t* data, size_t len) {
+            total += len;
+
+            while (len--) {
+                block[block_len++] = *data++;
+
+                if (block_len == 64) {
+                    compress();
+                    block_len = 0;
+                }
+            }
+        }
+
+        void finish(uint8_t* digest) {
+            uint64_t bits = total * 8;
+            uint8_t pad = 0x80;
+
+            update(&pad, 1);
+
+            pad = 0;
+            while (block_len != 56) update(&pad, 1);
+
+            for (int i = 7; 0 <= i; i--) {
+                uint8_t c = bits >> (i * 8);
+                update(&c, 1);
+            }
+
+            for (int i = 0; i < 8; i++) {
+                digest[i*4]   = h[i] >> 24;
+                digest[i*4+1] = h[i] >> 16;
+                digest[i*4+2] = h[i] >> 8;
+                digest[i*4+3] = h[i];
+            }
+        }
+
+        static void digest(const uint8_t* data, size_t len, uint8_t* out) {
+            Host_sha256 sha;
+
+            sha.begin();
+            sha.update(data, len);
+            sha.finish(out);
+        }
+};
+
+// 파티션 이미지 파일 ( 크기 고정, 처음 만들 때 0xFF 로 채움 )
+class OTA_file_flash : public OTA_flash {
+    private:
+        FILE*  fp;
+        size_t size;
+
+    public:
+        // 부팅 슬롯 상태 ( 테스트에서 확인용 )
+        bool activated;
+        bool confirmed;
+        bool rolled_back;
+        bool boot_pending;  // 부트로더가 정상 판정 대기 중인 것처럼
+
+        OTA_file_flash(const char* path, size_t size)
+            : size(size), activated(false), confirmed(false), rolled_back(false), boot_pending(false) {
+            std::vector<uint8_t> blank(OTA_SECTOR, 0xFF);
+
+            fp = fopen(path, "w+b");
+
+            for (size_t i = 0; fp && i < size; i += OTA_SECTOR) fwrite(blank.data(), 1, OTA_SECTOR, fp);
+        }
+
+        ~OTA_file_flash() { if (fp) fclose(fp); }
+
+        bool ok() { return fp != nullptr; }
+
+        size_t capacity() override { return size; }
+
+        bool write(uint32_t offset, const uint8_t* buf, size_t len) override {
+            size_t erase_len = (len + OTA_SECTOR - 1) / OTA_SECTOR * OTA_SECTOR;
+            std::vector<uint8_t> blank(erase_len, 0xFF);
+
+            if (!fp || size < offset + erase_len) return false;
+
+            fseek(fp, offset, SEEK_SET);
+            fwrite(blank.data(), 1, erase_len, fp);
+
+            fseek(fp, offset, SEEK_SET);
+            bool ok = fwrite(buf, 1, len, fp) == len;
+            fflush(fp);
+
+            return ok;
+        }
+
+        bool read(uint32_t offset, uint8_t* buf, size_t len) override {
+            if (!fp || size < offset + len) return false;
+
+            fseek(fp, offset, SEEK_SET);
+
+            return fread(buf, 1, len, fp) == len;
+        }
+
+        bool activate() override { activated = true; confirmed = false; return true; }
+        bool confirm() override { confirmed = true; boot_pending = false; return true; }
+        bool rollback() override { rolled_back = true; activated = false; boot_pending = false; return true; }
+        bool pending() override { return boot_pending; }
+};
+
+// 상태 파일은 메모리, 시간은 테스트가 직접 진행
+class OTA_host_platform : public OTA_platform {
+    private:
+        Host_sha256 sha;
+
+    public:
+        uint32_t clock_ms = 0;
+        int      restarts = 0;
+        bool     guarded  = false;
+        bool     verbose  = false;
+        std::map<std::string, std::vector<uint8_t>> files;
+
+        uint32_t now_ms() override { return clock_ms; }
+        void restart() override { restarts++; }
+
+        bool load(const char* path, uint8_t* buf, size_t len) override {
+            auto iter = files.find(path);
+
+            if (iter == files.end() || iter->second.size() < len) return false;
+
+            memcpy(buf, iter->second.data(), len);
+
+            return true;
+        }
+
+        bool store(const char* path, const uint8_t* buf, size_t len) override {
+            files[path].assign(buf, buf + len);
+
+            return true;
+        }
+
+        bool exists(const char* path) override { return files.count(path) != 0; }
+        void remove(const char* path) override { files.erase(path); }
+
+        void sha_begin() override { sha.begin(); }
+        void sha_update(const uint8_t* buf, size_t len) override { sha.update(buf, len); }
+        void sha_finish(uint8_t* digest) override { sha.finish(digest); }
+
+        void log(const char* msg) override { if (verbose) printf("%s\n", msg); }
+        void guard(bool on) override { guarded = on; }
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef SAMPLE_HOST_H
+#define SAMPLE_HOST_H
+
+/* 개요: 호스트(Linux)에서 Sampler_core.h 를 돌리기 위한 구현 입니다.
+ * --------------------------------------------
+ * 1. Fake_bus          : 읽을 때마다 1씩 늘어나는 값을 채우는 가짜 버스 ( 실패/초기화 실패 흉내 가능 )
+ * 2. Sample_host_slots : 블록 번호를 std::deque 로 주고받음 ( 태스크 없이 한 스레드에서 사용 )
+*/
+
+#include <Sampler_core.h>
+#include <deque>
+
+// 가짜 버스 ( 채널을 구분할 수 있게 base 부터 1씩 증가하는 값을 채움 )
+class Fake_bus : public Sample_bus {
+    public:
+        uint8_t  base;
+        uint32_t reads    = 0;
+        uint32_t fail_at  = 0;      // 0이 아니면 해당 번째(1부터) 읽기를 실패로
+        bool     begin_ok = true;
+
+        explicit Fake_bus(uint8_t base = 0) : base(base) {}
+
+        bool begin() override { return begin_ok; }
+
+        bool read(uint8_t* dst, size_t len) override {
+            reads++;
+
+            if (reads == fail_at) return false;
+
+            for (size_t i = 0; i < len; i++) dst[i] = (uint8_t)(base + reads - 1);
+
+            return true;
+        }
+};
+
+class Sample_host_slots : public Sample_slots {
+    private:
+        std::deque<uint8_t> free_q;
+        std::deque<uint8_t> ready_q;
+
+        static bool pop(std::deque<uint8_t>& q, uint8_t& idx) {
+            if (q.empty()) return false;
+
+            idx = q.front();
+            q.pop_front();
+
+            return true;
+        }
+
+    public:
+        void reset() override {
+            free_q  = { 0, 1 };
+            ready_q.clear();
+        }
+
+        bool pop_free(uint8_t& idx) override { return pop(free_q, idx); }
+        void push_free(uint8_t idx) override { free_q.push_back(idx); }
+        bool pop_ready(uint8_t& idx) override { return pop(ready_q, idx); }
+        void push_ready(uint8_t idx) override { ready_q.push_back(idx); }
+};
+
+#endif
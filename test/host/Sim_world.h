@@ -0,0 +1,201 @@
+#ifndef SIM_WORLD_H
+#define SIM_WORLD_H
+
+/* 개요: 기기 다수 시뮬레이터( test/test_fleet )의 가상 세계 입니다. ( 시계, AP, 브로커 )
+ * --------------------------------------------
+ * 1. test/host/arduino 의 Arduino/WiFi/PubSubClient 대역이 이 세계를 보고 동작합니다
+ * 2. 시계는 기기마다 따로 갑니다 ( Sim_node::t )
+ *    - millis()는 지금 실행 중인 기기( cur )의 시각, 실행 중인 기기가 없으면 세계 시각( now )
+ *    - 접속처럼 막히는(blocking) 호출은 그 기기의 시각만 앞당기고, 그동안 그 기기는 loop()를 돌지 못합니다
+ * 3. AP는 끄고 켤 수 있으며, 꺼지면 그 AP에 붙어있던 기기는 접속이 끊깁니다 ( epoch 로 구분 )
+ * 4. 브로커는 초당 accept_rate 개의 접속만 처리합니다
+ *    - 넘치는 접속은 대기열에서 기다리고, 대기가 SIM_MQTT_TIMEOUT 을 넘으면 기기쪽은 타임아웃으로 실패
+ *    - 꺼져있으면 바로 거절, 재시작하면 모든 세션이 끊깁니다
+ * 5. 초 단위로 접속 시도/성공/실패, 메시지 수/크기를 기록해 몰림(storm)을 측정합니다
+ * 6. 무작위 값은 고정 시드라 같은 시나리오는 항상 같은 결과가 나옵니다
+*/
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#define SIM_SCAN_MS       2000    // 비동기 스캔에 걸리는 시간
+#define SIM_ASSOC_MIN_MS  300     // AP 접속에 걸리는 시간 ( 최소 ~ 최대 사이 무작위 )
+#define SIM_ASSOC_MAX_MS  1500
+#define SIM_MQTT_TIMEOUT  15000   // PubSubClient 소켓 타임아웃 ( MQTT_SOCKET_TIMEOUT )
+#define SIM_SEED          33
+
+// 가상 AP
+typedef struct Sim_ap {
+    std::string ssid;
+    std::string password;
+    int32_t  rssi;
+    int32_t  channel;
+    bool     up;
+    uint32_t epoch;     // 꺼질 때마다 증가 ( 이전에 붙은 기기는 끊김 )
+} Sim_ap;
+
+// 기기 1대의 시계와 무선 상태
+typedef struct Sim_node {
+    uint32_t id;
+    uint32_t t;             // 기기 시각 ( ms )
+
+    bool     scanning;
+    bool     scan_valid;    // 스캔 결과가 남아있는지 ( scanDelete 전까지 )
+    uint32_t scan_done;     // 스캔 완료 시각
+    std::vector<int> scan_list;
+
+    int      ap;            // 접속(시도) 중인 AP ( 없으면 -1 )
+    uint32_t ap_epoch;
+    uint32_t assoc_at;      // 이 시각에 접속 완료
+} Sim_node;
+
+// 1초 동안의 브로커 측정값
+typedef struct Sim_second {
+    uint32_t attempts;
+    uint32_t accepted;
+    uint32_t refused;       // 꺼져 있어서 거절
+    uint32_t timeouts;      // 대기가 길어 기기쪽 타임아웃
+    uint32_t msgs;
+    uint32_t bytes;
+} Sim_second;
+
+class Sim_broker {
+    private:
+        uint32_t next_free;     // 대기열이 비는 시각
+
+    public:
+        bool     up;
+        uint32_t epoch;         // 재시작할 때마다 증가 ( 이전 세션은 끊김 )
+        uint32_t accept_rate;   // 초당 처리할 수 있는 접속 수
+        uint32_t rtt_ms;
+        uint32_t sessions;      // 현재 접속 중인 세션 수
+
+        std::vector<Sim_second> seconds;
+        std::vector<uint32_t>   connect_ms;     // 성공한 접속마다 걸린 시간 ( 기기 입장 )
+
+        void reset(uint32_t rate, uint32_t rtt) {
+            up          = true;
+            epoch       = 1;
+            accept_rate = rate;
+            rtt_ms      = rtt;
+            sessions    = 0;
+            next_free   = 0;
+            seconds.clear();
+            connect_ms.clear();
+        }
+
+        Sim_second& at(uint32_t t) {
+            if (seconds.size() <= t / 1000) seconds.resize(t / 1000 + 1, Sim_second());
+
+            return seconds[t / 1000];
+        }
+
+        // 접속 ( t: 시도 시각, elapsed: 기기가 기다린 시간 )
+        bool connect(uint32_t t, uint32_t& elapsed) {
+            at(t).attempts++;
+
+            if (!up) {
+                at(t).refused++;
+                elapsed = rtt_ms;
+                return false;
+            }
+
+            // 처리 순서를 기다림 ( 기기가 포기해도 브로커는 이미 받은 접속을 처리함 )
+            uint32_t start = std::max(t, next_free);
+            next_free = start + 1000 / accept_rate;
+
+            uint32_t latency = next_free - t + rtt_ms;
+
+            if (SIM_MQTT_TIMEOUT < latency) {
+                at(t).timeouts++;
+                elapsed = SIM_MQTT_TIMEOUT;
+                return false;
+            }
+
+            at(t + latency).accepted++;
+            connect_ms.push_back(latency);
+            elapsed = latency;
+            sessions++;
+
+            return true;
+        }
+
+        void publish(uint32_t t, size_t len) {
+            at(t).msgs++;
+            at(t).bytes += len;
+        }
+
+        // 끄기 ( 모든 세션 끊김 )
+        void stop() {
+            up = false;
+            epoch++;
+            sessions = 0;
+        }
+
+        void start(uint32_t t) {
+            up        = true;
+            next_free = t;
+        }
+};
+
+class Sim_world {
+    private:
+        Sim_world() = default;
+
+    public:
+        uint32_t now;           // 세계 시각 ( ms )
+        Sim_node* cur;          // 지금 실행 중인 기기 ( 없으면 nullptr )
+        std::vector<Sim_ap> aps;
+        Sim_broker broker;
+        std::mt19937 rng;
+
+        Sim_world& operator=(const Sim_world& ref) = delete;
+        static Sim_world& GetInstance();
+
+        void reset(uint32_t accept_rate, uint32_t rtt_ms) {
+            now = 0;
+            cur = nullptr;
+            aps.clear();
+            broker.reset(accept_rate, rtt_ms);
+            rng.seed(SIM_SEED);
+        }
+
+        uint32_t millis() { return cur ? cur->t : now; }
+
+        // 막히는 호출 ( 실행 중인 기기의 시각만 앞당김 )
+        void delay(uint32_t ms) { if (cur) cur->t += ms; }
+
+        // [min, max) 무작위
+        long random(long min, long max) {
+            if (max <= min) return min;
+
+            return std::uniform_int_distribution<long>(min, max - 1)(rng);
+        }
+
+        // 기기가 AP에 붙어있는지 ( 접속 완료 후 AP가 꺼진 적 없으면 )
+        bool linked(const Sim_node& node) {
+            if (node.ap < 0) return false;
+
+            const Sim_ap& ap = aps[node.ap];
+
+            return ap.up && ap.epoch == node.ap_epoch && node.assoc_at <= node.t;
+        }
+
+        void ap_down(int i) {
+            aps[i].up = false;
+            aps[i].epoch++;
+        }
+
+        void ap_up(int i) { aps[i].up = true; }
+};
+
+Sim_world& Sim_world::GetInstance() {
+    static Sim_world instance;
+
+    return instance;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/* 개요: 호스트 시뮬레이터용 Arduino 대역 입니다. ( test/test_fleet 전용 )
+ * --------------------------------------------
+ * 1. 펌웨어 헤더( env.h, Network_config.h 등 )를 그대로 컴파일할 수 있을 만큼만 흉내냅니다
+ * 2. millis()/delay()/random()은 Sim_world.h 의 가상 시계와 고정 시드 난수를 사용합니다
+ * 3. String 은 std::string 기반이며, ArduinoJson 은 ARDUINOJSON_ENABLE_ARDUINO_STRING=1 로 이 String 을 사용합니다
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <string>
+#include <Sim_world.h>
+
+#define F(s) (s)
+
+enum { DEC = 10, HEX = 16 };
+
+class String {
+    private:
+        std::string s;
+
+        static std::string num(unsigned long v, unsigned char base, bool neg) {
+            char tmp[40];
+            int  i = sizeof(tmp) - 1;
+
+            tmp[i] = '\0';
+            do { tmp[--i] = "0123456789abcdef"[v % base]; v /= base; } while (v);
+            if (neg) tmp[--i] = '-';
+
+            return tmp + i;
+        }
+
+    public:
+        String() {}
+        String(const char* cstr) : s(cstr ? cstr : "") {}
+        String(const char* cstr, unsigned int length) : s(cstr ? std::string(cstr, length) : "") {}
+        String(const std::string& str) : s(str) {}
+        explicit String(char c) : s(1, c) {}
+        explicit String(int v, unsigned char base = 10) : s(num(v < 0 && base == 10 ? -(long)v : (unsigned)v, base, v < 0 && base == 10)) {}
+        explicit String(unsigned int v, unsigned char base = 10) : s(num(v, base, false)) {}
+        explicit String(long v, unsigned char base = 10) : s(num(v < 0 && base == 10 ? -v : v, base, v < 0 && base == 10)) {}
+        explicit String(unsigned long v, unsigned char base = 10) : s(num(v, base, false)) {}
+        explicit String(double v, unsigned int decimals = 2) {
+            char tmp[48];
+
+            snprintf(tmp, sizeof(tmp), "%.*f", decimals, v);
+            s = tmp;
+        }
+
+        String& operator=(const char* cstr) { s = cstr ? cstr : ""; return *this; }
+
+        const char*  c_str() const { return s.c_str(); }
+        unsigned int length() const { return s.length(); }
+        bool isEmpty() const { return s.empty(); }
+        void reserve(unsigned int size) { s.reserve(size); }
+
+        bool concat(const char* cstr) { if (cstr) s += cstr; return true; }
+        bool concat(const char* cstr, unsigned int length) { if (cstr) s.append(cstr, length); return true; }
+        bool concat(const String& str) { s += str.s; return true; }
+        bool concat(char c) { s += c; return true; }
+
+        String& operator+=(const String& str) { s += str.s; return *this; }
+        String& operator+=(const char* cstr) { concat(cstr); return *this; }
+        String& operator+=(char c) { s += c; return *this; }
+
+        bool operator==(const String& str) const { return s == str.s; }
+        bool operator==(const char* cstr) const { return s == (cstr ? cstr : ""); }
+        bool operator!=(const String& str) const { return s != str.s; }
+        bool operator!=(const char* cstr) const { return !(*this == cstr); }
+        bool operator<(const String& str) const { return s < str.s; }
+
+        char operator[](unsigned int i) const { return i < s.size() ? s[i] : '\0'; }
+
+        String substring(unsigned int from) const { return from < s.size() ? s.substr(from) : ""; }
+        String substring(unsigned int from, unsigned int to) const {
+            if (to < from) std::swap(from, to);
+
+            return from < s.size() ? s.substr(from, to - from) : "";
+        }
+
+        int indexOf(char c, unsigned int from = 0) const {
+            size_t i = s.find(c, from);
+
+            return i == std::string::npos ? -1 : (int)i;
+        }
+
+        bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+        long toInt() const { return atol(s.c_str()); }
+
+        friend String operator+(const String& a, const String& b) { return a.s + b.s; }
+        friend String operator+(const String& a, const char* b) { return a.s + (b ? b : ""); }
+        friend String operator+(const char* a, const String& b) { return (a ? a : "") + b.s; }
+        friend String operator+(const String& a, char b) { return a.s + b; }
+};
+
+// ArduinoJson 이 String 으로 인식하는 타입
+class StringSumHelper : public String {
+    public:
+        using String::String;
+};
+
+class IPAddress {
+    private:
+        uint32_t addr;
+
+    public:
+        IPAddress(uint32_t addr = 0) : addr(addr) {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr(a | b << 8 | c << 16 | (uint32_t)d << 24) {}
+
+        operator uint32_t() const { return addr; }
+
+        String toString() const {
+            char tmp[16];
+
+            snprintf(tmp, sizeof(tmp), "%u.%u.%u.%u", addr & 0xff, addr >> 8 & 0xff, addr >> 16 & 0xff, addr >> 24);
+
+            return tmp;
+        }
+};
+
+// 로그 출력 ( 시뮬레이터 구성은 Log_off 라 거의 쓰이지 않음 )
+class HardwareSerial {
+    public:
+        void begin(unsigned long baud) {}
+        void flush() { fflush(stdout); }
+
+        void print(const char* v) { fputs(v, stdout); }
+        void print(const String& v) { fputs(v.c_str(), stdout); }
+        void print(long v) { ::printf("%ld", v); }
+        void println() { fputs("\n", stdout); }
+
+        template <typename T>
+        void println(const T& v) { print(v); println(); }
+
+        int printf(const char* fmt, ...) {
+            va_list args;
+
+            va_start(args, fmt);
+            int n = vprintf(fmt, args);
+            va_end(args);
+
+            return n;
+        }
+};
+
+inline HardwareSerial Serial;
+
+inline unsigned long millis() { return Sim_world::GetInstance().millis(); }
+inline unsigned long micros() { return millis() * 1000UL; }
+inline void delay(unsigned long ms) { Sim_world::GetInstance().delay(ms); }
+
+inline long random(long max) { return Sim_world::GetInstance().random(0, max); }
+inline long random(long min, long max) { return Sim_world::GetInstance().random(min, max); }
+
+// 시드를 고정해 재현되도록 무시
+inline void randomSeed(unsigned long seed) {}
+
+inline void configTime(long gmtOffset_sec, int daylightOffset_sec, const char* server) {}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef FS_H
+#define FS_H
+
+/* 개요: 호스트 시뮬레이터용 FS 대역 입니다. ( 파일은 항상 없음, 시뮬레이터는 env.txt 를 EnvData::parse() 로 넘김 ) */
+
+#include <Arduino.h>
+
+class File {
+    public:
+        operator bool() const { return false; }
+
+        int available() { return 0; }
+        String readString() { return ""; }
+        void close() {}
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef LITTLEFS_H
+#define LITTLEFS_H
+
+/* 개요: 호스트 시뮬레이터용 LittleFS 대역 입니다. ( 마운트는 항상 성공, 파일은 없음 ) */
+
+#include <FS.h>
+
+class LittleFSFS {
+    public:
+        bool begin(bool formatOnFail = false) { return true; }
+        File open(const char* path, const char* mode = "r") { return File(); }
+        bool exists(const char* path) { return false; }
+        bool remove(const char* path) { return false; }
+        size_t totalBytes() { return 0; }
+        size_t usedBytes() { return 0; }
+};
+
+inline LittleFSFS LittleFS;
+
+#endif
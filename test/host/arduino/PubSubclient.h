@@ -0,0 +1,117 @@
+#ifndef PUBSUBCLIENT_H
+#define PUBSUBCLIENT_H
+
+/* 개요: 호스트 시뮬레이터용 PubSubClient 대역 입니다. ( test/test_fleet 전용 )
+ * --------------------------------------------
+ * 1. 접속/전송은 Sim_world 의 가상 브로커( Sim_broker )로 갑니다
+ * 2. connect()는 브로커 대기 시간만큼 기기 시각을 앞당깁니다 ( 실제 PubSubClient 처럼 막히는 호출 )
+ * 3. 세션은 브로커가 재시작하거나( epoch ) 기기의 WiFi가 끊기면 끊긴 것으로 봅니다
+ * 4. 수신 메시지는 흉내내지 않습니다 ( 콜백은 등록만 )
+*/
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+class PubSubClient {
+    private:
+        Sim_node* node;         // 접속한 기기
+        uint32_t  epoch;        // 접속한 브로커 세대
+        bool      session;
+        int       _state;
+        size_t    pub_len;
+
+        MQTT_CALLBACK_SIGNATURE;
+
+        Sim_broker& broker() { return Sim_world::GetInstance().broker; }
+
+        void drop(int state) {
+            if (session && broker().up && broker().epoch == epoch) broker().sessions--;
+
+            session = false;
+            _state  = state;
+        }
+
+    public:
+        PubSubClient() : node(nullptr), epoch(0), session(false), _state(MQTT_DISCONNECTED), pub_len(0) {}
+        PubSubClient(const PubSubClient& ref) = delete;
+        ~PubSubClient() { drop(MQTT_DISCONNECTED); }
+
+        PubSubClient& setClient(WiFiClient& client) { return *this; }
+        PubSubClient& setServer(const char* domain, uint16_t port) { return *this; }
+        PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE) { this->callback = callback; return *this; }
+        bool setBufferSize(uint16_t size) { return true; }
+
+        bool connect(const char* id, const char* user, const char* pass) {
+            Sim_world& world = Sim_world::GetInstance();
+            uint32_t elapsed;
+
+            if (connected()) return true;
+
+            node = world.cur;
+
+            if (!world.linked(*node)) {
+                _state = MQTT_CONNECT_FAILED;
+                return false;
+            }
+
+            bool ok = broker().connect(node->t, elapsed);
+
+            node->t += elapsed;
+            session  = ok;
+            epoch    = broker().epoch;
+            _state   = ok ? MQTT_CONNECTED : (broker().up ? MQTT_CONNECTION_TIMEOUT : MQTT_CONNECT_FAILED);
+
+            return ok;
+        }
+
+        // 브로커 재시작, WiFi 끊김이면 false
+        bool connected() {
+            if (!session) return false;
+
+            if (!broker().up || broker().epoch != epoch || !Sim_world::GetInstance().linked(*node)) drop(MQTT_CONNECTION_LOST);
+
+            return session;
+        }
+
+        void disconnect() { drop(MQTT_DISCONNECTED); }
+        int state() { return _state; }
+        bool subscribe(const char* topic) { return connected(); }
+        bool loop() { return connected(); }
+
+        bool beginPublish(const char* topic, unsigned int plength, bool retained) {
+            pub_len = 0;
+
+            return connected();
+        }
+
+        size_t write(uint8_t c) { pub_len++; return 1; }
+        size_t write(const uint8_t* buf, size_t size) { pub_len += size; return size; }
+        size_t print(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+
+        int endPublish() {
+            if (!connected()) return 0;
+
+            broker().publish(node->t, pub_len);
+
+            return 1;
+        }
+
+        bool publish(const char* topic, const char* payload) {
+            if (!beginPublish(topic, strlen(payload), false)) return false;
+
+            print(payload);
+
+            return endPublish();
+        }
+};
+
+#endif
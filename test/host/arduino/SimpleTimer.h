@@ -0,0 +1,22 @@
+#ifndef SIMPLETIMER_H
+#define SIMPLETIMER_H
+
+/* 개요: 호스트 시뮬레이터용 SimpleTimer 대역 입니다. ( kiryanenko/SimpleTimer 와 같은 동작, 가상 시계 사용 ) */
+
+#include <Arduino.h>
+
+class SimpleTimer {
+    private:
+        unsigned long _start;
+        unsigned long _interval;
+
+    public:
+        SimpleTimer() : SimpleTimer(0) {}
+        explicit SimpleTimer(unsigned long interval) : _start(millis()), _interval(interval) {}
+
+        bool isReady() { return _start + _interval <= millis(); }
+        void setInterval(unsigned long interval) { _interval = interval; }
+        void reset() { _start = millis(); }
+};
+
+#endif
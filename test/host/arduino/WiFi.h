@@ -0,0 +1,146 @@
+#ifndef WIFI_H
+#define WIFI_H
+
+/* 개요: 호스트 시뮬레이터용 WiFi 대역 입니다. ( test/test_fleet 전용 )
+ * --------------------------------------------
+ * 1. 전역 WiFi 는 하나지만, 지금 실행 중인 기기( Sim_world::cur )의 무선 상태를 다룹니다
+ * 2. 스캔은 SIM_SCAN_MS 뒤에 끝나며, 그 시점에 켜져있는 AP만 보입니다
+ * 3. begin()은 켜져있고 비밀번호가 맞는 AP면 SIM_ASSOC_MIN_MS ~ SIM_ASSOC_MAX_MS 뒤에 접속됩니다 ( 아니면 접속되지 않음 )
+ * 4. WiFiClient 는 브로커 RTT 측정( Broker_selector )에만 쓰이며 브로커가 켜져있는지만 봅니다
+*/
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS     = 0,
+    WL_NO_SSID_AVAIL   = 1,
+    WL_SCAN_COMPLETED  = 2,
+    WL_CONNECTED       = 3,
+    WL_CONNECT_FAILED  = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED    = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+typedef enum { WIFI_AUTH_OPEN = 0, WIFI_AUTH_WPA2_PSK = 3 } wifi_auth_mode_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+class WiFiClass {
+    private:
+        Sim_world& world() { return Sim_world::GetInstance(); }
+        Sim_node&  node() { return *Sim_world::GetInstance().cur; }
+
+        const Sim_ap* scanned(uint8_t i) {
+            Sim_node& n = node();
+
+            return (n.scan_valid && i < n.scan_list.size()) ? &world().aps[n.scan_list[i]] : nullptr;
+        }
+
+    public:
+        int16_t scanNetworks(bool async = false) {
+            Sim_node& n = node();
+
+            if (!n.scanning) {
+                n.scanning  = true;
+                n.scan_done = n.t + SIM_SCAN_MS;
+            }
+
+            return WIFI_SCAN_RUNNING;
+        }
+
+        int16_t scanComplete() {
+            Sim_node& n = node();
+
+            if (n.scanning && n.scan_done <= n.t) {
+                n.scanning   = false;
+                n.scan_valid = true;
+                n.scan_list.clear();
+
+                for (size_t i = 0; i < world().aps.size(); i++)
+                    if (world().aps[i].up) n.scan_list.push_back(i);
+            }
+
+            if (n.scanning) return WIFI_SCAN_RUNNING;
+
+            return n.scan_valid ? n.scan_list.size() : WIFI_SCAN_FAILED;
+        }
+
+        void scanDelete() {
+            node().scan_valid = false;
+            node().scan_list.clear();
+        }
+
+        String SSID(uint8_t i) { const Sim_ap* ap = scanned(i); return ap ? ap->ssid.c_str() : ""; }
+        int32_t RSSI(uint8_t i) { const Sim_ap* ap = scanned(i); return ap ? ap->rssi : 0; }
+        wifi_auth_mode_t encryptionType(uint8_t i) { return WIFI_AUTH_WPA2_PSK; }
+
+        String SSID() { return isConnected() ? world().aps[node().ap].ssid.c_str() : ""; }
+        int32_t RSSI() { return isConnected() ? world().aps[node().ap].rssi : 0; }
+        int32_t channel() { return isConnected() ? world().aps[node().ap].channel : 0; }
+        uint8_t* BSSID() { return nullptr; }
+
+        bool mode(wifi_mode_t m) {
+            if (m == WIFI_OFF) node().ap = -1;
+
+            return true;
+        }
+
+        wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0, const uint8_t* bssid = nullptr, bool connect = true) {
+            Sim_node& n = node();
+
+            n.ap = -1;
+
+            for (size_t i = 0; i < world().aps.size(); i++) {
+                const Sim_ap& ap = world().aps[i];
+
+                if (!ap.up || ap.ssid != ssid || ap.password != (passphrase ? passphrase : "")) continue;
+
+                n.ap       = i;
+                n.ap_epoch = ap.epoch;
+                n.assoc_at = n.t + world().random(SIM_ASSOC_MIN_MS, SIM_ASSOC_MAX_MS);
+                break;
+            }
+
+            return WL_DISCONNECTED;
+        }
+
+        wl_status_t begin(const String& ssid, const String& passphrase, int32_t channel = 0, const uint8_t* bssid = nullptr, bool connect = true) {
+            return begin(ssid.c_str(), passphrase.c_str(), channel, bssid, connect);
+        }
+
+        bool disconnect(bool wifioff = false, bool eraseap = false) {
+            node().ap = -1;
+
+            return true;
+        }
+
+        bool isConnected() { return world().linked(node()); }
+
+        wl_status_t status() { return isConnected() ? WL_CONNECTED : WL_DISCONNECTED; }
+
+        IPAddress localIP() {
+            if (!isConnected()) return IPAddress();
+
+            return IPAddress(10, 0, node().id >> 8 & 0xff, node().id & 0xff);
+        }
+};
+
+inline WiFiClass WiFi;
+
+class WiFiClient {
+    public:
+        int connect(const char* host, uint16_t port, int32_t timeout = 0) {
+            Sim_world& world = Sim_world::GetInstance();
+
+            world.delay(world.broker.rtt_ms);
+
+            return world.broker.up;
+        }
+
+        void stop() {}
+};
+
+#endif
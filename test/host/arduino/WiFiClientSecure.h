@@ -0,0 +1,13 @@
+#ifndef WIFICLIENTSECURE_H
+#define WIFICLIENTSECURE_H
+
+/* 개요: 호스트 시뮬레이터용 WiFiClientSecure 대역 입니다. ( Device_config.h 컴파일용, 시뮬레이터는 TLS_off ) */
+
+#include <WiFi.h>
+
+class WiFiClientSecure : public WiFiClient {
+    public:
+        void setInsecure() {}
+};
+
+#endif
@@ -0,0 +1,167 @@
+/* 개요: 수신측 MSGPACK 해석( Payload_decoder.h )을 확인하는 호스트 테스트 입니다.
+ * --------------------------------------------
+ * 1. 실행: pio test -e native -f test_codec
+ * 2. 기기가 ArduinoJson으로 만드는 것과 같은 바이트열을 직접 만들어 해석 결과를 비교합니다
+*/
+
+#include <unity.h>
+#include <Payload_decoder.h>
+
+// MessagePack 바이트열 작성 ( ArduinoJson 과 같은 방식: 가장 짧은 형식 선택 )
+struct Mp_writer {
+    std::vector<uint8_t> out;
+
+    void be(uint64_t v, int n) { for (int i = n - 1; 0 <= i; i--) out.push_back(v >> (i * 8)); }
+
+    Mp_writer& array(size_t n) {
+        if (n < 16) out.push_back(0x90 | n);
+        else { out.push_back(0xdc); be(n, 2); }
+        return *this;
+    }
+
+    Mp_writer& num(int64_t v) {
+        if (0 <= v && v < 128)       out.push_back(v);
+        else if (-32 <= v && v < 0)  out.push_back((uint8_t)v);
+        else if (0 <= v && v < 256)  { out.push_back(0xcc); be(v, 1); }
+        else if (0 <= v && v < 65536){ out.push_back(0xcd); be(v, 2); }
+        else if (0 <= v)             { out.push_back(0xce); be(v, 4); }
+        else if (-128 <= v)          { out.push_back(0xd0); be(v, 1); }
+        else                         { out.push_back(0xd2); be(v, 4); }
+        return *this;
+    }
+
+    Mp_writer& real(float f) {
+        uint32_t bits;
+
+        memcpy(&bits, &f, 4);
+        out.push_back(0xca); be(bits, 4);
+        return *this;
+    }
+
+    Mp_writer& str(const char* s) {
+        size_t n = strlen(s);
+
+        if (n < 32) out.push_back(0xa0 | n);
+        else { out.push_back(0xd9); be(n, 1); }
+        out.insert(out.end(), s, s + n);
+        return *this;
+    }
+
+    Mp_writer& boolean(bool b) { out.push_back(b ? 0xc3 : 0xc2); return *this; }
+
+    // "[기기이름] " 접두사를 붙인 페이로드
+    std::vector<uint8_t> payload(const char* name) {
+        std::string prefix = std::string("[") + name + "] ";
+        std::vector<uint8_t> buf(prefix.begin(), prefix.end());
+
+        buf.insert(buf.end(), out.begin(), out.end());
+        return buf;
+    }
+};
+
+static std::string decode(const std::vector<uint8_t>& buf, std::string* device = nullptr) {
+    std::string name, json;
+
+    TEST_ASSERT_TRUE(payload_decode(buf.data(), buf.size(), name, json));
+    if (device) *device = name;
+
+    return json;
+}
+
+void test_net() {
+    Mp_writer mp;
+    std::string device;
+
+    mp.array(4).num(SCHEMA_NET).str("home").num(-52).num(16820416);
+
+    TEST_ASSERT_EQUAL_STRING("{\"schema\":\"net\",\"ssid\":\"home\",\"rssi\":-52,\"ip\":\"192.168.0.1\"}",
+        decode(mp.payload("esp-01"), &device).c_str());
+    TEST_ASSERT_EQUAL_STRING("esp-01", device.c_str());
+}
+
+void test_lfs_without_prefix() {
+    Mp_writer mp;
+
+    mp.array(3).num(SCHEMA_LFS).num(1441792).num(20480);
+
+    TEST_ASSERT_EQUAL_STRING("{\"schema\":\"lfs\",\"total\":1441792,\"used\":20480}", decode(mp.out).c_str());
+}
+
+void test_scan_repeats() {
+    Mp_writer mp;
+
+    mp.array(7).num(SCHEMA_SCAN).str("a").num(-40).boolean(true).str("b \"q\"").num(-91).boolean(false);
+
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"schema\":\"scan\",\"networks\":[{\"ssid\":\"a\",\"rssi\":-40,\"secured\":true},"
+        "{\"ssid\":\"b \\\"q\\\"\",\"rssi\":-91,\"secured\":false}]}",
+        decode(mp.payload("d")).c_str());
+}
+
+void test_agg_floats() {
+    Mp_writer mp;
+
+    mp.array(10).num(SCHEMA_AGG).str("rssi").num(60000).num(60)
+      .real(-70).real(-41).real(-55.5f).real(-55).real(-47).real(-42);
+
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"schema\":\"agg\",\"m\":\"rssi\",\"w\":60000,\"n\":60,\"min\":-70,\"max\":-41,"
+        "\"mean\":-55.5,\"p50\":-55,\"p90\":-47,\"p99\":-42}",
+        decode(mp.payload("d")).c_str());
+}
+
+// 모르는 스키마, 필드 수가 다른 경우는 이름 없이 그대로
+void test_unknown_schema() {
+    Mp_writer mp, short_net;
+
+    mp.array(3).num(42).str("x").num(300);
+    short_net.array(2).num(SCHEMA_NET).str("home");
+
+    TEST_ASSERT_EQUAL_STRING("{\"schema\":42,\"fields\":[\"x\",300]}", decode(mp.out).c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"schema\":3,\"fields\":[\"home\"]}", decode(short_net.out).c_str());
+}
+
+// 명령 응답 문자열 ( JSON 문자열도 그대로 문자열 필드로 )
+void test_text_reply() {
+    Mp_writer plain, stats;
+
+    plain.array(2).num(SCHEMA_TEXT).str("sleep disabled until reboot");
+    stats.array(2).num(SCHEMA_TEXT).str("{\"pub_cnt\":12,\"broker\":\"10.0.0.2\"}");
+
+    TEST_ASSERT_EQUAL_STRING("{\"schema\":\"text\",\"text\":\"sleep disabled until reboot\"}", decode(plain.payload("d")).c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"schema\":\"text\",\"text\":\"{\\\"pub_cnt\\\":12,\\\"broker\\\":\\\"10.0.0.2\\\"}\"}",
+        decode(stats.payload("d")).c_str());
+}
+
+// 잘리거나 MSGPACK 이 아닌 페이로드는 거부
+void test_reject_invalid() {
+    Mp_writer mp;
+    std::string device, json;
+
+    mp.array(4).num(SCHEMA_NET).str("home").num(-52).num(16820416);
+    mp.out.pop_back();
+
+    TEST_ASSERT_FALSE(payload_decode(mp.out.data(), mp.out.size(), device, json));
+
+    const char* text = "[d] wake-up! : 192.168.0.1";
+    TEST_ASSERT_FALSE(payload_decode((const uint8_t*)text, strlen(text), device, json));
+
+    const char* bad_prefix = "[d";
+    TEST_ASSERT_FALSE(payload_decode((const uint8_t*)bad_prefix, strlen(bad_prefix), device, json));
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_net);
+    RUN_TEST(test_lfs_without_prefix);
+    RUN_TEST(test_scan_repeats);
+    RUN_TEST(test_agg_floats);
+    RUN_TEST(test_unknown_schema);
+    RUN_TEST(test_text_reply);
+    RUN_TEST(test_reject_invalid);
+    return UNITY_END();
+}
@@ -0,0 +1,107 @@
+/* 개요: 펌웨어 네트워크 로직을 기기 수백~수천 대로 돌려 접속 몰림(storm)을 측정하는 시뮬레이션 입니다.
+ * --------------------------------------------
+ * 1. 실행: pio test -e sim -v ( 결과표는 -v 에서 보임 )
+ * 2. 기기 수, 브로커 처리량은 빌드 플래그로 바꿀 수 있습니다 ( ex: -D SIM_DEVICES=5000 -D SIM_ACCEPT_RATE=500 )
+ * 3. 시나리오마다 세계를 새로 만들고, 사건 직후부터의 측정값을 출력합니다
+ *    - 전체 재부팅    : 정전 복구처럼 모든 기기가 SIM_REBOOT_SPREAD_MS 안에 다시 부팅
+ *    - AP 정전       : 모든 AP가 SIM_OUTAGE_MS 동안 꺼졌다 켜짐
+ *    - 브로커 재시작  : 브로커가 SIM_OUTAGE_MS 동안 꺼졌다 켜짐 ( 모든 세션 끊김 )
+ * 4. 모든 기기가 SIM_RECOVER_MS 안에 다시 접속하고, 정상 AP를 차단한 기기가 없어야 통과입니다
+*/
+
+#include <unity.h>
+#include <Fleet_sim.h>
+
+#ifndef SIM_DEVICES
+#define SIM_DEVICES         1000
+#endif
+#ifndef SIM_ACCEPT_RATE
+#define SIM_ACCEPT_RATE     200     // 브로커가 초당 처리하는 접속 수
+#endif
+#define SIM_RTT_MS          20
+#define SIM_REPORT_MS       10000   // 기기별 보고 주기
+#define SIM_SETTLE_MS       60000   // 첫 부팅 후 안정될 때까지
+#define SIM_REBOOT_SPREAD_MS 1000
+#define SIM_OUTAGE_MS       30000
+#define SIM_RECOVER_MS      90000
+
+Sim_fleet fleet;
+
+// 첫 부팅 후 모두 접속될 때까지 돌림
+static void boot_fleet() {
+    fleet.init(SIM_DEVICES, SIM_ACCEPT_RATE, SIM_RTT_MS, SIM_REBOOT_SPREAD_MS, SIM_REPORT_MS);
+    fleet.run_for(SIM_SETTLE_MS);
+
+    // 브로커 처리량이 모자라 안정되지 못하면 첫 부팅 측정값을 보여줌
+    if (fleet.connected() != SIM_DEVICES) TEST_MESSAGE(Sim_fleet::format("boot", fleet.report()).c_str());
+
+    TEST_ASSERT_EQUAL_UINT32(SIM_DEVICES, fleet.connected());
+}
+
+// 사건 이후 측정값 출력 및 확인
+static void check_recovery(const char* name) {
+    fleet.run_for(SIM_RECOVER_MS);
+
+    Sim_report r = fleet.report();
+
+    TEST_MESSAGE(Sim_fleet::format(name, r).c_str());
+
+    TEST_ASSERT_EQUAL_UINT32(SIM_DEVICES, r.recovered);
+    TEST_ASSERT_EQUAL_UINT32(SIM_DEVICES, fleet.connected());
+    TEST_ASSERT_EQUAL_UINT32(0, r.banned);
+}
+
+// 모든 기기가 거의 동시에 다시 부팅
+void test_mass_reboot() {
+    boot_fleet();
+
+    fleet.reboot_all(SIM_REBOOT_SPREAD_MS);
+    fleet.mark();
+
+    check_recovery("mass reboot");
+}
+
+// 모든 AP가 꺼졌다 켜짐
+void test_ap_outage() {
+    Sim_world& world = Sim_world::GetInstance();
+
+    boot_fleet();
+
+    for (size_t i = 0; i < world.aps.size(); i++) world.ap_down(i);
+    fleet.run_for(SIM_OUTAGE_MS);
+
+    TEST_ASSERT_EQUAL_UINT32(0, fleet.connected());
+
+    for (size_t i = 0; i < world.aps.size(); i++) world.ap_up(i);
+    fleet.mark();
+
+    check_recovery("ap outage");
+}
+
+// 브로커가 꺼졌다 켜짐
+void test_broker_restart() {
+    Sim_world& world = Sim_world::GetInstance();
+
+    boot_fleet();
+
+    world.broker.stop();
+    fleet.run_for(SIM_OUTAGE_MS);
+
+    TEST_ASSERT_EQUAL_UINT32(0, fleet.connected());
+
+    world.broker.start(world.now);
+    fleet.mark();
+
+    check_recovery("broker restart");
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_mass_reboot);
+    RUN_TEST(test_ap_outage);
+    RUN_TEST(test_broker_restart);
+    return UNITY_END();
+}
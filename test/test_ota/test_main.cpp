@@ -0,0 +1,354 @@
+/* 개요: OTA_core 를 파티션 이미지 파일로 돌려보는 호스트 테스트 입니다.
+ * --------------------------------------------
+ * 1. 실행: pio test -e native -f test_ota
+ * 2. 재부팅은 OTA_core 를 새로 만들어 흉내냅니다 ( 파티션 파일과 상태 파일은 유지 )
+ * 3. 환경변수 OTA_IMAGE 에 실제 펌웨어(.bin) 경로를 주면 그 파일로도 전체 흐름을 확인합니다
+*/
+
+#include <unity.h>
+#include <OTA_host.h>
+#include <stdlib.h>
+#include <memory>
+
+#define PART_PATH  "ota_part.bin"
+#define PART_SIZE  0x140000           // 기본 파티션 테이블의 app 크기
+
+// 기기 한 대 ( 재부팅해도 flash, platform 은 유지 )
+struct Device {
+    OTA_file_flash    flash;
+    OTA_host_platform platform;
+    OTA_sync_writer   writer;
+    std::unique_ptr<OTA_core> core;
+    std::vector<FT_frame> replies;
+    std::vector<std::vector<uint8_t>> raw;
+
+    Device() : flash(PART_PATH, PART_SIZE), writer(&flash) { boot(); }
+
+    void boot() {
+        platform.clock_ms = 0;
+        writer.reset(0);
+        core.reset(new OTA_core(&flash, &writer, &platform));
+        core->boot_check();
+        core->init([this](const uint8_t* buf, size_t len) {
+            FT_frame frame;
+
+            raw.emplace_back(buf, buf + len);
+            ft_parse(raw.back().data(), len, frame);
+            replies.push_back(frame);
+        });
+    }
+
+    // setup() 맨 앞의 boot_check() 직후 죽거나 멈춘 부팅 ( init, run 까지 가지 못함 )
+    void crash() {
+        platform.clock_ms = 0;
+        core.reset(new OTA_core(&flash, &writer, &platform));
+        core->boot_check();
+    }
+
+    FT_frame send(uint8_t op, uint8_t id, uint32_t offset, const uint8_t* data, size_t len, uint32_t crc) {
+        std::vector<uint8_t> frame(FT_HEADER_SIZE + len);
+
+        ft_header(frame.data(), op, id, 0, offset, crc);
+        if (len) memcpy(frame.data() + FT_HEADER_SIZE, data, len);
+
+        replies.clear();
+        core->handle(frame.data(), frame.size());
+
+        if (replies.empty()) return FT_frame{0, 0, 0xFF, 0, 0, nullptr, 0};
+
+        return replies.back();
+    }
+
+    FT_frame open(uint8_t id, const std::vector<uint8_t>& image, const uint8_t* sha) {
+        return send(FT_OP_PUT, id, image.size(), sha, OTA_SHA_SIZE, 0);
+    }
+
+    FT_frame chunk(uint8_t id, const std::vector<uint8_t>& image, uint32_t offset) {
+        size_t len = std::min((size_t)FT_CHUNK_SIZE, image.size() - offset);
+
+        return send(FT_OP_DATA, id, offset, image.data() + offset, len, ft_crc32(image.data() + offset, len));
+    }
+
+    // offset 부터 end 까지 전송 ( 마지막 ACK 의 offset 반환 )
+    uint32_t stream(uint8_t id, const std::vector<uint8_t>& image, uint32_t offset, uint32_t end) {
+        while (offset < end) {
+            FT_frame ack = chunk(id, image, offset);
+
+            TEST_ASSERT_EQUAL_UINT8(FT_OK, ack.status);
+            offset = ack.offset;
+            core->run(false);
+        }
+
+        return offset;
+    }
+
+    void tick(uint32_t ms, bool healthy) {
+        platform.clock_ms += ms;
+        core->run(healthy);
+    }
+};
+
+static std::vector<uint8_t> make_image(size_t size, uint32_t seed) {
+    std::vector<uint8_t> image(size);
+
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        image[i] = seed >> 16;
+    }
+
+    return image;
+}
+
+static void check_partition(Device& dev, const std::vector<uint8_t>& image) {
+    std::vector<uint8_t> buf(image.size());
+
+    TEST_ASSERT_TRUE(dev.flash.read(0, buf.data(), buf.size()));
+    TEST_ASSERT_EQUAL_MEMORY(image.data(), buf.data(), image.size());
+}
+
+// 전송 → COMMIT → 1초 후 재부팅 → 새 이미지 정상 확정
+static void install(Device& dev, const std::vector<uint8_t>& image) {
+    uint8_t sha[OTA_SHA_SIZE];
+
+    Host_sha256::digest(image.data(), image.size(), sha);
+
+    FT_frame ack = dev.open(1, image, sha);
+    TEST_ASSERT_EQUAL_UINT8(FT_OK, ack.status);
+    TEST_ASSERT_EQUAL_UINT32(0, ack.offset);
+
+    TEST_ASSERT_EQUAL_UINT32(image.size(), dev.stream(1, image, 0, image.size()));
+
+    ack = dev.send(FT_OP_COMMIT, 1, 0, nullptr, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(FT_OK, ack.status);
+    TEST_ASSERT_TRUE(dev.flash.activated);
+    TEST_ASSERT_TRUE(dev.platform.exists(OTA_BOOT_PATH));
+    TEST_ASSERT_FALSE(dev.platform.exists(OTA_STATE_PATH));
+
+    dev.tick(500, false);
+    TEST_ASSERT_EQUAL_INT(0, dev.platform.restarts);
+    dev.tick(600, false);
+    TEST_ASSERT_EQUAL_INT(1, dev.platform.restarts);
+
+    check_partition(dev, image);
+}
+
+void test_full_update() {
+    Device dev;
+    std::vector<uint8_t> image = make_image(3 * OTA_SECTOR + 123, 1);
+
+    install(dev, image);
+
+    dev.boot();
+    TEST_ASSERT_TRUE(dev.core->pending());
+
+    dev.tick(10, true);
+    TEST_ASSERT_FALSE(dev.core->pending());
+    TEST_ASSERT_TRUE(dev.flash.confirmed);
+    TEST_ASSERT_FALSE(dev.platform.exists(OTA_BOOT_PATH));
+}
+
+// 중간에 재부팅돼도 저장된 위치부터 이어받음
+void test_resume_after_reboot() {
+    Device dev;
+    std::vector<uint8_t> image = make_image(OTA_STATE_INTERVAL * 2 + 5000, 2);
+    uint8_t sha[OTA_SHA_SIZE];
+
+    Host_sha256::digest(image.data(), image.size(), sha);
+
+    TEST_ASSERT_EQUAL_UINT8(FT_OK, dev.open(1, image, sha).status);
+    dev.stream(1, image, 0, OTA_STATE_INTERVAL + 3 * FT_CHUNK_SIZE);
+    TEST_ASSERT_TRUE(dev.platform.exists(OTA_STATE_PATH));
+
+    dev.boot();
+
+    FT_frame ack = dev.open(2, image, sha);
+    TEST_ASSERT_EQUAL_UINT8(FT_OK, ack.status);
+    TEST_ASSERT_EQUAL_UINT32(OTA_STATE_INTERVAL, ack.offset);
+
+    dev.stream(2, image, ack.offset, image.size());
+    TEST_ASSERT_EQUAL_UINT8(FT_OK, dev.send(FT_OP_COMMIT, 2, 0, nullptr, 0, 0).status);
+
+    check_partition(dev, image);
+}
+
+// 다른 이미지로 OPEN 하면 처음부터
+void test_other_image_restarts() {
+    Device dev;
+    std::vector<uint8_t> image = make_image(OTA_STATE_INTERVAL * 2, 3);
+    std::vector<uint8_t> other = make_image(OTA_STATE_INTERVAL * 2, 4);
+    uint8_t sha[OTA_SHA_SIZE], other_sha[OTA_SHA_SIZE];
+
+    Host_sha256::digest(image.data(), image.size(), sha);
+    Host_sha256::digest(other.data(), other.size(), other_sha);
+
+    dev.open(1, image, sha);
+    dev.stream(1, image, 0, OTA_STATE_INTERVAL + FT_CHUNK_SIZE);
+
+    dev.boot();
+    TEST_ASSERT_EQUAL_UINT32(0, dev.open(2, other, other_sha).offset);
+}
+
+// 잘못된 청크 CRC 는 거부하고 위치를 유지
+void test_bad_chunk_crc() {
+    Device dev;
+    std::vector<uint8_t> image = make_image(2 * FT_CHUNK_SIZE, 5);
+    uint8_t sha[OTA_SHA_SIZE];
+
+    Host_sha256::digest(image.data(), image.size(), sha);
+    dev.open(1, image, sha);
+
+    FT_frame ack = dev.send(FT_OP_DATA, 1, 0, image.data(), FT_CHUNK_SIZE, 0xDEADBEEF);
+    TEST_ASSERT_EQUAL_UINT8(FT_ERR_CRC, ack.status);
+    TEST_ASSERT_EQUAL_UINT32(0, ack.offset);
+
+    ack = dev.send(FT_OP_DATA, 1, FT_CHUNK_SIZE, image.data(), FT_CHUNK_SIZE, ft_crc32(image.data(), FT_CHUNK_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(FT_ERR_OFFSET, ack.status);
+}
+
+// 이미지 SHA-256 이 다르면 COMMIT 실패, 부팅 파티션은 그대로
+void test_bad_sha() {
+    Device dev;
+    std::vector<uint8_t> image = make_image(OTA_SECTOR + 10, 6);
+    uint8_t sha[OTA_SHA_SIZE];
+
+    Host_sha256::digest(image.data(), image.size(), sha);
+    sha[0] ^= 0xFF;
+
+    dev.open(1, image, sha);
+    dev.stream(1, image, 0, image.size());
+
+    FT_frame ack = dev.send(FT_OP_COMMIT, 1, 0, nullptr, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(FT_ERR_CRC, ack.status);
+    TEST_ASSERT_FALSE(dev.flash.activated);
+    TEST_ASSERT_FALSE(dev.platform.exists(OTA_BOOT_PATH));
+}
+
+// 파티션보다 큰 이미지는 OPEN 에서 거부
+void test_too_large() {
+    Device dev;
+    uint8_t sha[OTA_SHA_SIZE] = {0};
+
+    FT_frame ack = dev.send(FT_OP_PUT, 1, PART_SIZE + 1, sha, OTA_SHA_SIZE, 0);
+    TEST_ASSERT_EQUAL_UINT8(FT_ERR_SIZE, ack.status);
+}
+
+// 정상 판정 없이 OTA_BOOT_ATTEMPTS 번 재부팅되면 롤백
+void test_rollback_after_boot_attempts() {
+    Device dev;
+
+    install(dev, make_image(OTA_SECTOR, 7));
+
+    for (int i = 1; i < OTA_BOOT_ATTEMPTS; i++) {
+        dev.boot();
+        TEST_ASSERT_TRUE(dev.core->pending());
+        TEST_ASSERT_FALSE(dev.flash.rolled_back);
+    }
+
+    int restarts = dev.platform.restarts;
+
+    dev.boot();
+    TEST_ASSERT_TRUE(dev.flash.rolled_back);
+    TEST_ASSERT_FALSE(dev.core->pending());
+    TEST_ASSERT_EQUAL_INT(restarts + 1, dev.platform.restarts);
+    TEST_ASSERT_FALSE(dev.platform.exists(OTA_BOOT_PATH));
+}
+
+// 새 이미지가 초기화 중에 죽어도 부팅 횟수가 쌓여 롤백, 그 전까지는 멈춤 감시
+void test_rollback_on_crash_before_init() {
+    Device dev;
+
+    install(dev, make_image(OTA_SECTOR, 9));
+
+    for (int i = 1; i < OTA_BOOT_ATTEMPTS; i++) {
+        dev.crash();
+        TEST_ASSERT_TRUE(dev.platform.guarded);
+        TEST_ASSERT_FALSE(dev.flash.rolled_back);
+    }
+
+    dev.crash();
+    TEST_ASSERT_TRUE(dev.flash.rolled_back);
+}
+
+// 정상 판정되면 멈춤 감시 해제
+void test_guard_released_on_confirm() {
+    Device dev;
+
+    install(dev, make_image(OTA_SECTOR, 10));
+    dev.boot();
+    TEST_ASSERT_TRUE(dev.platform.guarded);
+
+    dev.tick(10, true);
+    TEST_ASSERT_FALSE(dev.platform.guarded);
+    TEST_ASSERT_FALSE(dev.flash.pending());
+}
+
+// 부팅 파일이 없어도 부트로더가 대기 중이면 정상 판정 대기
+void test_pending_from_bootloader() {
+    Device dev;
+
+    dev.flash.boot_pending = true;
+    dev.boot();
+    TEST_ASSERT_TRUE(dev.core->pending());
+    TEST_ASSERT_TRUE(dev.platform.exists(OTA_BOOT_PATH));
+
+    dev.tick(10, true);
+    TEST_ASSERT_TRUE(dev.flash.confirmed);
+}
+
+// OTA_HEALTH_TIMEOUT 안에 정상 판정이 없으면 롤백
+void test_rollback_on_health_timeout() {
+    Device dev;
+
+    install(dev, make_image(OTA_SECTOR, 8));
+    dev.boot();
+
+    dev.tick(OTA_HEALTH_TIMEOUT - 10, false);
+    TEST_ASSERT_FALSE(dev.flash.rolled_back);
+
+    dev.tick(20, false);
+    TEST_ASSERT_TRUE(dev.flash.rolled_back);
+    TEST_ASSERT_FALSE(dev.flash.confirmed);
+}
+
+// 실제 펌웨어 파일로 전체 흐름 ( OTA_IMAGE 가 없으면 생략 )
+void test_real_image() {
+    const char* path = getenv("OTA_IMAGE");
+
+    if (!path) TEST_IGNORE_MESSAGE("OTA_IMAGE 미지정");
+
+    FILE* fp = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+
+    std::vector<uint8_t> image;
+    uint8_t buf[4096];
+    size_t n;
+
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) image.insert(image.end(), buf, buf + n);
+    fclose(fp);
+
+    TEST_ASSERT_TRUE(image.size() <= PART_SIZE);
+
+    Device dev;
+    install(dev, image);
+}
+
+void setUp() {}
+
+void tearDown() { remove(PART_PATH); }
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_update);
+    RUN_TEST(test_resume_after_reboot);
+    RUN_TEST(test_other_image_restarts);
+    RUN_TEST(test_bad_chunk_crc);
+    RUN_TEST(test_bad_sha);
+    RUN_TEST(test_too_large);
+    RUN_TEST(test_rollback_after_boot_attempts);
+    RUN_TEST(test_rollback_on_crash_before_init);
+    RUN_TEST(test_guard_released_on_confirm);
+    RUN_TEST(test_pending_from_bootloader);
+    RUN_TEST(test_rollback_on_health_timeout);
+    RUN_TEST(test_real_image);
+    return UNITY_END();
+}
@@ -0,0 +1,235 @@
+/* 개요: Sampler_core 를 가짜 버스로 돌려보는 호스트 테스트 입니다.
+ * --------------------------------------------
+ * 1. 실행: pio test -e native -f test_sampler
+ * 2. 시각은 테스트가 직접 넘기므로( tick(now_us) ) 지터도 정확히 맞춰볼 수 있습니다
+*/
+
+#include <unity.h>
+#include <Sample_host.h>
+
+#define TICK_US 1000    // ESP32 Arduino 기본 tick ( 1ms )
+
+Sample_host_slots slots;
+Sampler_core core(&slots);
+
+// 6바이트 샘플로 블록 하나를 채울 만큼 주기대로 tick
+static void fill_block(int64_t& now_us, uint32_t period_us) {
+    for (uint32_t i = 0; i < SAMPLE_BLOCK_SIZE / 6; i++) {
+        core.tick(now_us);
+        now_us += period_us;
+    }
+}
+
+// 주기가 0이거나 1 tick 보다 짧으면 시작하지 않음
+void test_reject_short_period() {
+    Fake_bus bus;
+
+    TEST_ASSERT_FALSE(core.start(10, TICK_US));     // 채널 없음
+
+    TEST_ASSERT_TRUE(core.add_channel(&bus, 2));
+    TEST_ASSERT_FALSE(core.start(0, TICK_US));
+    TEST_ASSERT_FALSE(core.start(1, 2 * TICK_US));  // 1ms < tick 2ms
+    TEST_ASSERT_FALSE(core.start(10, 0));
+    TEST_ASSERT_FALSE(core.started());
+
+    TEST_ASSERT_TRUE(core.start(1, TICK_US));
+    TEST_ASSERT_EQUAL_UINT32(1000, core.period());
+    TEST_ASSERT_FALSE(core.start(1, TICK_US));      // 이미 시작
+}
+
+// tick 단위로 내림 된 주기가 블록 헤더에 기록됨
+void test_period_rounded_to_tick() {
+    Fake_bus bus;
+
+    core.add_channel(&bus, 1);
+    TEST_ASSERT_TRUE(core.start(25, 10 * TICK_US));
+    TEST_ASSERT_EQUAL_UINT32(20000, core.period());
+}
+
+// 채널 수, 블록 크기, 버스 초기화 실패, 시작 후 추가는 거부
+void test_channel_limits() {
+    Fake_bus a, b, c, d, e, broken;
+
+    broken.begin_ok = false;
+
+    TEST_ASSERT_FALSE(core.add_channel(&broken, 2));
+    TEST_ASSERT_FALSE(core.add_channel(&a, 0));
+    TEST_ASSERT_FALSE(core.add_channel(nullptr, 2));
+    TEST_ASSERT_TRUE(core.add_channel(&a, 250));
+    TEST_ASSERT_TRUE(core.add_channel(&b, 250));
+    TEST_ASSERT_FALSE(core.add_channel(&c, 13));    // 512 초과
+    TEST_ASSERT_TRUE(core.add_channel(&c, 6));
+    TEST_ASSERT_TRUE(core.add_channel(&d, 6));
+    TEST_ASSERT_FALSE(core.add_channel(&e, 1));     // SAMPLE_MAX_CHANNEL 초과
+
+    core.init();
+    TEST_ASSERT_TRUE(core.add_channel(&a, 1));
+    TEST_ASSERT_TRUE(core.start(1, TICK_US));
+    TEST_ASSERT_FALSE(core.add_channel(&b, 1));
+}
+
+// 채널 순서대로 이어붙인 샘플이 블록에 차고, 다 차면 loop() 쪽으로 넘어감
+void test_block_layout() {
+    Fake_bus a(0x10), b(0x80);
+    int64_t now = 5000;
+
+    core.add_channel(&a, 2);
+    core.add_channel(&b, 4);
+    core.start(1, TICK_US);
+
+    uint32_t per_block = SAMPLE_BLOCK_SIZE / 6;
+
+    for (uint32_t i = 0; i + 1 < per_block; i++) { core.tick(now); now += 1000; }
+    TEST_ASSERT_NULL(core.take());
+
+    core.tick(now);
+    Sample_block* block = core.take();
+
+    TEST_ASSERT_NOT_NULL(block);
+    TEST_ASSERT_EQUAL_UINT32(0, block->seq);
+    TEST_ASSERT_EQUAL_UINT32(5000, block->t0_us);
+    TEST_ASSERT_EQUAL_UINT32(1000, block->period_us);
+    TEST_ASSERT_EQUAL_UINT16(per_block, block->count);
+    TEST_ASSERT_EQUAL_UINT16(per_block * 6, block->size);
+
+    const uint8_t first[6] = { 0x10, 0x10, 0x80, 0x80, 0x80, 0x80 };
+    const uint8_t second[6] = { 0x11, 0x11, 0x81, 0x81, 0x81, 0x81 };
+    TEST_ASSERT_EQUAL_MEMORY(first,  block->data,     6);
+    TEST_ASSERT_EQUAL_MEMORY(second, block->data + 6, 6);
+    TEST_ASSERT_EQUAL_UINT32(16, SAMPLE_HEADER_SIZE);
+
+    core.release(block);
+    TEST_ASSERT_NULL(core.take());
+}
+
+// 블록을 돌려주지 않으면 두 블록이 찬 뒤부터 overrun
+void test_overrun_without_release() {
+    Fake_bus bus;
+    int64_t now = 1;
+
+    core.add_channel(&bus, 6);
+    core.start(1, TICK_US);
+
+    fill_block(now, 1000);
+    fill_block(now, 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, core.overruns());
+
+    core.tick(now); now += 1000;
+    core.tick(now); now += 1000;
+    TEST_ASSERT_EQUAL_UINT32(2, core.overruns());
+
+    // 하나 돌려주면 다시 채움
+    Sample_block* block = core.take();
+    TEST_ASSERT_EQUAL_UINT32(0, block->seq);
+    core.release(block);
+
+    uint32_t samples = core.samples();
+    core.tick(now);
+    TEST_ASSERT_EQUAL_UINT32(samples + 1, core.samples());
+    TEST_ASSERT_EQUAL_UINT32(2, core.overruns());
+
+    TEST_ASSERT_EQUAL_UINT32(1, core.take()->seq);
+}
+
+// 버스 읽기 실패는 샘플을 남기지 않고 error 로 셈
+void test_bus_error() {
+    Fake_bus a, b;
+    int64_t now = 1;
+
+    b.fail_at = 2;
+    core.add_channel(&a, 3);
+    core.add_channel(&b, 3);
+    core.start(1, TICK_US);
+
+    core.tick(now); now += 1000;
+    core.tick(now); now += 1000;
+    core.tick(now);
+
+    TEST_ASSERT_EQUAL_UINT32(2, core.samples());
+    TEST_ASSERT_EQUAL_UINT32(1, core.errors());
+}
+
+// 실제 간격과 주기의 차이를 지터로 기록
+void test_jitter() {
+    Fake_bus bus;
+    char out[160];
+
+    core.add_channel(&bus, 1);
+    core.start(10, TICK_US);
+
+    core.tick(100000);
+    core.tick(110000);      // 0
+    core.tick(120300);      // 300
+    core.tick(129900);      // 400
+
+    core.stats(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("samples: 4, overrun: 0, error: 0\njitter(us): min 0, max 400, avg 233", out);
+}
+
+// 채널 형식대로 숫자로 해석 ( 집계 입력 )
+void test_decode() {
+    const uint8_t be[4] = { 0xff, 0x38, 0x00, 0x01 };
+    float v;
+
+    TEST_ASSERT_TRUE(Sampler_core::decode(be, 2, SAMPLE_INT_BE, v));
+    TEST_ASSERT_FLOAT_WITHIN(0, -200, v);
+    TEST_ASSERT_TRUE(Sampler_core::decode(be, 2, SAMPLE_UINT_BE, v));
+    TEST_ASSERT_FLOAT_WITHIN(0, 65336, v);
+    TEST_ASSERT_TRUE(Sampler_core::decode(be, 2, SAMPLE_INT_LE, v));
+    TEST_ASSERT_FLOAT_WITHIN(0, 0x38ff, v);
+    TEST_ASSERT_TRUE(Sampler_core::decode(be + 2, 2, SAMPLE_UINT_LE, v));
+    TEST_ASSERT_FLOAT_WITHIN(0, 256, v);
+    TEST_ASSERT_TRUE(Sampler_core::decode(be, 1, SAMPLE_INT_BE, v));
+    TEST_ASSERT_FLOAT_WITHIN(0, -1, v);
+    TEST_ASSERT_TRUE(Sampler_core::decode(be, 4, SAMPLE_INT_BE, v));
+    TEST_ASSERT_FLOAT_WITHIN(1, -13107199, v);
+
+    TEST_ASSERT_FALSE(Sampler_core::decode(be, 3, SAMPLE_INT_BE, v));
+    TEST_ASSERT_FALSE(Sampler_core::decode(be, 2, SAMPLE_RAW, v));
+}
+
+// 블록의 샘플마다 해석되는 채널 값만 넘김
+void test_for_each() {
+    Fake_bus a(10), b(0x80), c(0);
+    int64_t now = 1;
+    uint32_t calls[3] = { 0, 0, 0 };
+    float last[3] = { 0, 0, 0 };
+
+    core.add_channel(&a, 1, SAMPLE_UINT_BE);
+    core.add_channel(&b, 3, SAMPLE_INT_BE);     // 3바이트는 해석하지 않음
+    core.add_channel(&c, 2, SAMPLE_RAW);
+    core.start(1, TICK_US);
+
+    fill_block(now, 1000);
+
+    Sample_block* block = core.take();
+    TEST_ASSERT_NOT_NULL(block);
+
+    core.for_each(block, [&](uint8_t ch, float v) { calls[ch]++; last[ch] = v; });
+
+    TEST_ASSERT_EQUAL_UINT32(block->count, calls[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, calls[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, calls[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0, 10 + block->count - 1, last[0]);
+}
+
+void setUp() {
+    slots.reset();
+    core.init();
+}
+
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reject_short_period);
+    RUN_TEST(test_period_rounded_to_tick);
+    RUN_TEST(test_channel_limits);
+    RUN_TEST(test_block_layout);
+    RUN_TEST(test_overrun_without_release);
+    RUN_TEST(test_bus_error);
+    RUN_TEST(test_jitter);
+    RUN_TEST(test_decode);
+    RUN_TEST(test_for_each);
+    return UNITY_END();
+}
@@ -0,0 +1,229 @@
+/* 개요: 스트리밍 압축( Stream_compressor.h )의 압축/해제를 확인하는 호스트 테스트 입니다.
+ * --------------------------------------------
+ * 1. 실행: pio test -e native -f test_zip
+ * 2. 압축 결과를 다시 해제해 원본과 같은지 비교합니다 ( 입력/출력을 조각내 스트리밍 경로도 확인 )
+ * 3. 깨진 압축 데이터는 해제가 실패해야 합니다 ( 윈도우 밖을 읽지 않음 )
+ * 4. 잘린 데이터는 해제가 실패하거나, 출력이 헤더의 원본 길이보다 짧아야 합니다
+*/
+
+#include <unity.h>
+#include <Stream_compressor.h>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+LZ_Encoder encoder;
+LZ_Decoder decoder;
+
+// piece 바이트씩 나눠 넣어 압축
+static Bytes compress(const Bytes& src, size_t piece = 0) {
+    Bytes out;
+
+    encoder.begin([&out](const uint8_t* buf, size_t len) { out.insert(out.end(), buf, buf + len); return true; });
+
+    if (!piece) piece = src.size() ? src.size() : 1;
+
+    for (size_t i = 0; i < src.size(); i += piece)
+        TEST_ASSERT_TRUE(encoder.write(src.data() + i, std::min(piece, src.size() - i)));
+
+    TEST_ASSERT_TRUE(encoder.finish());
+    TEST_ASSERT_EQUAL_UINT32(out.size(), encoder.size());
+
+    return out;
+}
+
+// piece 바이트씩 나눠 넣어 해제 ( 실패 시 false )
+static bool decompress(const Bytes& src, Bytes& out, size_t piece = 0) {
+    bool ok = true;
+
+    out.clear();
+    decoder.begin([&out](const uint8_t* buf, size_t len) { out.insert(out.end(), buf, buf + len); return true; });
+
+    if (!piece) piece = src.size() ? src.size() : 1;
+
+    for (size_t i = 0; i < src.size() && ok; i += piece)
+        ok = decoder.write(src.data() + i, std::min(piece, src.size() - i));
+
+    return decoder.finish() && ok;
+}
+
+static void check_round_trip(const Bytes& src, size_t piece = 0) {
+    Bytes comp = compress(src, piece);
+    Bytes back;
+
+    TEST_ASSERT_TRUE(decompress(comp, back, piece));
+    TEST_ASSERT_EQUAL_size_t(src.size(), back.size());
+    if (src.size()) TEST_ASSERT_EQUAL_MEMORY(src.data(), back.data(), src.size());
+}
+
+// 고정 시드 의사 난수 ( 압축되지 않는 입력용 )
+static Bytes noise(size_t len, uint32_t seed) {
+    Bytes out(len);
+
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245u + 12345u;
+        out[i] = seed >> 16;
+    }
+
+    return out;
+}
+
+// 압축 데이터의 일치 항목 ( 거리, 길이 ) 목록
+static void matches(const Bytes& comp, std::vector<uint32_t>& dist, std::vector<uint32_t>& len) {
+    size_t i = 0;
+
+    while (i < comp.size()) {
+        uint8_t flags = comp[i++];
+
+        for (int k = 0; k < 8 && i < comp.size(); k++, flags >>= 1) {
+            if (flags & 1) { i++; continue; }
+            if (comp.size() < i + 2) return;
+
+            uint16_t token = (comp[i] << 8) | comp[i + 1];
+
+            dist.push_back((token >> LZ_LEN_BITS) + 1);
+            len.push_back((token & ((1 << LZ_LEN_BITS) - 1)) + LZ_MIN_MATCH);
+            i += 2;
+        }
+    }
+}
+
+// 빈 입력, 1바이트
+void test_empty_and_one_byte() {
+    Bytes empty;
+    Bytes one = { 'x' };
+
+    TEST_ASSERT_EQUAL_size_t(0, compress(empty).size());
+    check_round_trip(empty);
+    check_round_trip(one);
+}
+
+// 압축되지 않는 입력은 리터럴만 ( 8byte 마다 플래그 1byte 추가 )
+void test_incompressible() {
+    Bytes src = noise(1000, 27);
+    Bytes comp = compress(src);
+
+    TEST_ASSERT_LESS_OR_EQUAL(src.size() + (src.size() + 7) / 8, comp.size());
+    check_round_trip(src);
+    check_round_trip(src, 13);
+}
+
+// 반복이 많은 입력은 크게 줄어듬
+void test_repetitive() {
+    Bytes src;
+    const char* line = "SSID: office-ap[*] (-61dbm)\n";
+
+    for (int i = 0; i < 64; i++) src.insert(src.end(), line, line + strlen(line));
+
+    Bytes comp = compress(src);
+
+    TEST_ASSERT_LESS_THAN(src.size() / 10, comp.size());
+    check_round_trip(src);
+    check_round_trip(src, 1);
+}
+
+// 윈도우( 1KB )보다 긴 입력: 원형 버퍼가 여러번 돌고, 거리는 윈도우를 넘지 않음
+void test_longer_than_window() {
+    Bytes block = noise(300, 7);
+    Bytes src;
+
+    // 가까운 반복( 300byte 전 )과 윈도우 밖 반복( 이전 블록 세트 ) 을 섞음
+    for (int r = 0; r < 5; r++) {
+        Bytes fresh = noise(900, 100 + r);
+
+        src.insert(src.end(), block.begin(), block.end());
+        src.insert(src.end(), block.begin(), block.end());
+        src.insert(src.end(), fresh.begin(), fresh.end());
+    }
+
+    TEST_ASSERT_GREATER_THAN(3 * LZ_RING_SIZE, src.size());
+
+    Bytes comp = compress(src, 7);
+    std::vector<uint32_t> dist, len;
+
+    matches(comp, dist, len);
+
+    TEST_ASSERT_TRUE(!dist.empty());
+    for (uint32_t d : dist) TEST_ASSERT_LESS_OR_EQUAL(LZ_WINDOW, d);
+
+    check_round_trip(src);
+    check_round_trip(src, 7);
+    check_round_trip(src, 1);
+}
+
+// 같은 바이트가 길게 이어지면 최대 길이( 66byte ) 일치가 나옴
+void test_max_match() {
+    Bytes src(1 + 3 * LZ_MAX_MATCH, 'a');
+    Bytes comp = compress(src);
+    std::vector<uint32_t> dist, len;
+
+    matches(comp, dist, len);
+
+    TEST_ASSERT_EQUAL_size_t(3, len.size());
+    for (uint32_t n : len) TEST_ASSERT_EQUAL_UINT32(LZ_MAX_MATCH, n);
+
+    check_round_trip(src);
+
+    // 최대 길이 + 1: 남은 1byte는 리터럴
+    src.push_back('a');
+    check_round_trip(src);
+}
+
+// 일치 항목 중간에서 잘리면 실패, 리터럴에서 잘리면 출력이 원본 길이( 헤더 )보다 짧음
+void test_truncated() {
+    Bytes src(1 + 3 * LZ_MAX_MATCH, 'b');   // 리터럴 1개 + 최대 일치 3개로 끝남
+    Bytes comp = compress(src);
+    Bytes back;
+
+    comp.pop_back();
+
+    TEST_ASSERT_FALSE(decompress(comp, back));
+    TEST_ASSERT_LESS_THAN(src.size(), back.size());
+
+    src.push_back('c');                     // 리터럴로 끝남
+    comp = compress(src);
+    comp.pop_back();
+
+    TEST_ASSERT_TRUE(decompress(comp, back));
+    TEST_ASSERT_EQUAL_size_t(src.size() - 1, back.size());
+}
+
+// 출력보다 먼 거리를 가리키는 일치는 실패 ( 윈도우 밖을 읽지 않음 )
+void test_corrupt_distance() {
+    Bytes comp = { 0x01, 'a', 0xFF, 0xC0 };  // 리터럴 1개 후 거리 1024 일치
+    Bytes back;
+
+    TEST_ASSERT_FALSE(decompress(comp, back));
+
+    Bytes first = { 0x00, 0x00, 0x00 };     // 첫 항목부터 일치 ( 거리 1, 출력 없음 )
+
+    TEST_ASSERT_FALSE(decompress(first, back));
+}
+
+// 무작위 데이터를 넣어도 출력 범위를 벗어나지 않음 ( 성공하든 실패하든 )
+void test_garbage() {
+    for (uint32_t seed = 1; seed <= 200; seed++) {
+        Bytes comp = noise(1 + seed * 7 % 500, seed);
+        Bytes back;
+
+        decompress(comp, back, 1 + seed % 5);
+
+        TEST_ASSERT_LESS_OR_EQUAL(comp.size() * LZ_MAX_MATCH, back.size());
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_and_one_byte);
+    RUN_TEST(test_incompressible);
+    RUN_TEST(test_repetitive);
+    RUN_TEST(test_longer_than_window);
+    RUN_TEST(test_max_match);
+    RUN_TEST(test_truncated);
+    RUN_TEST(test_corrupt_distance);
+    RUN_TEST(test_garbage);
+    return UNITY_END();
+}